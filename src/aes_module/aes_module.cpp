@@ -13,8 +13,11 @@ AESLib aesLib;
 
 // AESLib related variables
 unsigned char ciphertext[2*INPUT_BUFFER_LIMIT] = {0}; // Create array to store encrypted data
+static_assert(sizeof(ciphertext) >= ENCRYPTED_HEX_LENGTH(INPUT_BUFFER_LIMIT - 1) / 2, "Ciphertext of longest input must fit");
 byte aes_key[16]; // AES Encryption Key
 byte enc_ivs[NUM_IVS][N_BLOCK]; // General initialization vectors
+unsigned long encryptionCount = 0; // Encryptions since boot
+unsigned long encryptedBlockCount = 0; // AES blocks encrypted since boot
 
 // Initialize aesLib
 void aesModuleInit() {
@@ -31,7 +34,9 @@ void aesModuleInit() {
 // Encrypt the data and convert it to hexadecimal representation
 void encryptAndConvertToHex(const char* data, char* encryptedData, byte iv[]) {
     uint16_t dataLength = strlen(data); // Get the length of the input data
+    encryptionCount++;
     int cipherLength = aesLib.encrypt((byte*)data, dataLength, (byte*)ciphertext, aes_key, sizeof(aes_key), iv); // Encrypt the data
+    encryptedBlockCount += cipherLength / N_BLOCK;
     
     // Convert the encrypted data to hexadecimal representation
     for (int i = 0; i < cipherLength; i++) {
@@ -43,3 +48,13 @@ void encryptAndConvertToHex(const char* data, char* encryptedData, byte iv[]) {
 void generateNewIV(byte destinationIV[], const byte sourceIV[]) {
     memcpy(destinationIV, sourceIV, N_BLOCK); // Copy the source IV to the destination IV
 }
+
+// Get number of encryptions since boot
+unsigned long getEncryptionCount() {
+    return encryptionCount;
+}
+
+// Get number of AES blocks encrypted since boot
+unsigned long getEncryptedBlockCount() {
+    return encryptedBlockCount;
+}
@@ -13,6 +13,8 @@
 #include <AESLib.h>
 
 #define INPUT_BUFFER_LIMIT (128 + 1) // Max size of input data buffer for encryption
+// Hex length of ciphertext for plaintext of given length, CMS padding always adds 1...16 bytes, terminator included
+#define ENCRYPTED_HEX_LENGTH(length) (2 * ((length) / N_BLOCK + 1) * N_BLOCK + 1)
 #define NUM_IVS 24 // Number of IVs 
 
 // Array of IVs which can be used in other modules
@@ -27,4 +29,10 @@ void encryptAndConvertToHex(const char* data, char* encryptedData, byte iv[]);
 // Function to generate new iv vector
 void generateNewIV(byte destinationIV[], const byte sourceIV[]);
 
+// Function to get number of encryptions since boot
+unsigned long getEncryptionCount();
+
+// Function to get number of AES blocks encrypted since boot
+unsigned long getEncryptedBlockCount();
+
 #endif
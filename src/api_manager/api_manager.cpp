@@ -8,31 +8,50 @@
 
 #include "api_manager.h"
 #include "../globals/globals.h"
+#include "../local_server/local_server.h"
+#include "../transport_module/transport_module.h"
+#include "../cipher_cache/cipher_cache.h"
+#include "../flash_strings/flash_strings.h"
+
+// API node path keys
+const char ApiManager::AIR_PRESSURE_KEY[] PROGMEM = "air_pressure";
+const char ApiManager::HUMIDITY_KEY[] PROGMEM = "humidity";
+const char ApiManager::LUMINOSITY_KEY[] PROGMEM = "luminosity";
+const char ApiManager::SOIL_MOISTURE_KEY[] PROGMEM = "soil_moisture";
+const char ApiManager::TEMPERATURE_KEY[] PROGMEM = "temperature";
+const char ApiManager::WATER_TANK_LEVEL_KEY[] PROGMEM = "water_tank_level";
+const char ApiManager::LATEST_WATERING_TIME_KEY[] PROGMEM = "latest_watering_time";
+const char ApiManager::LATEST_SENSOR_READING_TIME_KEY[] PROGMEM = "latest_sensor_reading_time";
+const char ApiManager::WATER_TANK_REFILL_NOTIFICATION_KEY[] PROGMEM = "refill_water_tank";
 
 // Function to set up API call for device and history data
-bool ApiManager::setupApiCallWithHistoryData(const String& deviceId, const String& networkName, FirebaseJson json, const String& nodePathKey) {
+bool ApiManager::setupApiCallWithHistoryData(const String& deviceId, const String& networkName, const JsonWriter& json, const char* nodePathKey, const char* encryptedValue) {
     char encryptedWifiSSID[INPUT_BUFFER_LIMIT] = {0}; // Create array to store encrypted WiFi SSID
-    byte temp_enc_iv[N_BLOCK]; // Create array to store temporary initialization vector
+    char formattedDate[FORMATTED_DATE_LENGTH]; // Create array to store formatted date
+
+    cipherCache.encrypt(CACHED_HISTORY_SSID, networkName.c_str(), encryptedWifiSSID); // Encrypt network name once per SSID
 
-    generateNewIV(temp_enc_iv, enc_ivs[18]); // Generate a new IV for encryption
-    encryptAndConvertToHex(networkName.c_str(), encryptedWifiSSID, temp_enc_iv); // Encrypt network name and convert to hex
-    String encryptedWifiSSIDString(encryptedWifiSSID); // Create String object to hold the encrypted WiFi SSID data
+    // Keep latest reading for local clients, also when upload fails
+    localServer.updateReading(nodePathKey, encryptedValue, getCurrentEpochTime());
 
-    String nodePath = "devices/" + deviceId; // Define device node path
+    PathBuilder nodePath; // Define device node path
+    nodePath.add("devices/").add(deviceId);
     if (handleApiCall(json, nodePath)) {
-        // Create a history node path and make another API call to store data to history
-        String historyNodePath = "history/" + nodePathKey + "/" + getFormattedDate() + encryptedWifiSSIDString + "/" + deviceId + "/" + getCurrentTimeAsString();
-        // Call handleApiCall function and return its result
-        return handleApiCall(json, historyNodePath);
+        // Create a history node path and append reading to current history bucket
+        getFormattedDate(formattedDate, sizeof(formattedDate));
+        PathBuilder historyNodePath;
+        historyNodePath.add("history/").add(nodePathKey).add("/").add(formattedDate).add(encryptedWifiSSID).add("/").add(deviceId).add("/");
+        // Call append of history module and return its result
+        return historyModule.append(historyNodePath, getCurrentEpochTime(), encryptedValue);
     } else {
         return false; // Return false if first handleApiCall fails
     }
 }
 
-// Function to send data to firebase
-bool ApiManager::handleApiCall(FirebaseJson json, const String& nodePath) {
-    // Call sendFireBaseData of firebase_module.cpp
-    if (sendFirebaseData(json, nodePath.c_str())) {
+// Function to send data with selected transport
+bool ApiManager::handleApiCall(const JsonWriter& json, const PathBuilder& nodePath) {
+    // Call send of transport selected in transport_module.h
+    if (transport.send(json, nodePath)) {
         return true; // Return true if request succeeds
     } else {
         return false; // Return false if request fails
@@ -41,23 +60,25 @@ bool ApiManager::handleApiCall(FirebaseJson json, const String& nodePath) {
 
 // Function to handle device registration related data to firebase
 bool ApiManager::encryptAndSendDeviceRegistration(const String& deviceId, const String& networkName) {
+    ArenaScope arenaScope(cycleArena); // Free upload buffers on return
     char encryptedWifiSSID[INPUT_BUFFER_LIMIT] = {0}; // Create array to store encrypted WiFi SSID
     char encryptedDeviceId[INPUT_BUFFER_LIMIT] = {0}; // Create array to store encrypted deviceId
     char encryptedDeviceName[INPUT_BUFFER_LIMIT] = {0}; // Create array to store encrypted device name
     
-    encryptAndConvertToHex(networkName.c_str(), encryptedWifiSSID, enc_ivs[5]); // Encrypt network name and convert to hex
-    encryptAndConvertToHex(deviceId.c_str(), encryptedDeviceId, enc_ivs[6]); // Encrypt deviceId and convert to hex
-    encryptAndConvertToHex(DEVICE_NAME, encryptedDeviceName, enc_ivs[7]); // Encrypt device name and convert to hex
+    cipherCache.encrypt(CACHED_REGISTRATION_SSID, networkName.c_str(), encryptedWifiSSID); // Encrypt network name once per SSID
+    cipherCache.encrypt(CACHED_REGISTRATION_DEVICE_ID, deviceId.c_str(), encryptedDeviceId); // Encrypt deviceId once
+    cipherCache.encrypt(CACHED_REGISTRATION_DEVICE_NAME, DEVICE_NAME, encryptedDeviceName); // Encrypt device name once
 
-    FirebaseJson json; // Create FirebaseJson object to store JSON payload
+    JsonWriter json(cycleArena, JSON_PAYLOAD_LIMIT); // Create JsonWriter to serialize payload into arena buffer
     // Set device registration related fields to JSON payload with encrypted data
-    json.set("/authorized", false);
-    json.set("/ssid", encryptedWifiSSID);
-    json.set("/macAddress", encryptedDeviceId);
-    json.set("/name", encryptedDeviceName);
+    json.set("authorized", false);
+    json.set("ssid", encryptedWifiSSID);
+    json.set("macAddress", encryptedDeviceId);
+    json.set("name", encryptedDeviceName);
 
     // Define node path
-    String nodePath = "authorized_devices/" + deviceId;
+    PathBuilder nodePath;
+    nodePath.add("authorized_devices/").add(deviceId);
 
     // call handleApiCall data function and return its result
     return handleApiCall(json, nodePath);
@@ -65,19 +86,20 @@ bool ApiManager::encryptAndSendDeviceRegistration(const String& deviceId, const
 
 // Function to send device info related data to firebase
 bool ApiManager::encryptAndSendDeviceInfo(const String& deviceId, const String& networkName, const String& localIp) {
+    ArenaScope arenaScope(cycleArena); // Free upload buffers on return
     char encryptedFirmwareVersion[INPUT_BUFFER_LIMIT] = {0}; // Create array to store encrypted firmware version
     char encryptedDeviceName[INPUT_BUFFER_LIMIT] = {0}; // Create array to store encrypted device name
     char encryptedIpAddress[INPUT_BUFFER_LIMIT] = {0}; // Create array to store encrypted ip address
     char encryptedWifiSSID[INPUT_BUFFER_LIMIT] = {0}; // Create array to store encrypted WiFi SSID
     char encryptedDeviceId[INPUT_BUFFER_LIMIT] = {0}; // Create array to store encrypted deviceId
 
-    encryptAndConvertToHex(FIRMWARE_VERSION, encryptedFirmwareVersion, enc_ivs[0]); // Encrypt firmware version and convert to hex
-    encryptAndConvertToHex(DEVICE_NAME, encryptedDeviceName, enc_ivs[1]); // Encrypt device name and convert to hex
-    encryptAndConvertToHex(localIp.c_str(), encryptedIpAddress, enc_ivs[2]); // Encrypt ip address and convert to hex
-    encryptAndConvertToHex(networkName.c_str(), encryptedWifiSSID, enc_ivs[3]); // Encrypt network name and convert to hex
-    encryptAndConvertToHex(deviceId.c_str(), encryptedDeviceId, enc_ivs[4]); // Encrypt deviceId and convert to hex
+    cipherCache.encrypt(CACHED_FIRMWARE_VERSION, FIRMWARE_VERSION, encryptedFirmwareVersion); // Encrypt firmware version once
+    cipherCache.encrypt(CACHED_DEVICE_NAME, DEVICE_NAME, encryptedDeviceName); // Encrypt device name once
+    cipherCache.encrypt(CACHED_IP_ADDRESS, localIp.c_str(), encryptedIpAddress); // Encrypt ip address once per address
+    cipherCache.encrypt(CACHED_SSID, networkName.c_str(), encryptedWifiSSID); // Encrypt network name once per SSID
+    cipherCache.encrypt(CACHED_DEVICE_ID, deviceId.c_str(), encryptedDeviceId); // Encrypt deviceId once
 
-    FirebaseJson json; // Create FirebaseJson object to store JSON payload
+    JsonWriter json(cycleArena, JSON_PAYLOAD_LIMIT); // Create JsonWriter to serialize payload into arena buffer
     // Set device info related fields to JSON payload with encrypted data
     json.set("name", encryptedDeviceName);
     json.set("firmware", encryptedFirmwareVersion);
@@ -86,154 +108,195 @@ bool ApiManager::encryptAndSendDeviceInfo(const String& deviceId, const String&
     json.set("macAddress", encryptedDeviceId);
     
     // Define node path and call handleApiCall function
-    String nodePath = "devices/" + deviceId;
+    PathBuilder nodePath;
+    nodePath.add("devices/").add(deviceId);
     return handleApiCall(json, nodePath); // Return result of handleApiCall
 }
 
 // Function to send temperature data to firebase
-bool ApiManager::encryptAndSendTemperature(float temperature, const String& deviceId, const String& networkName) {
+bool ApiManager::encryptAndSendTemperature(const FixedPoint& temperature, const String& deviceId, const String& networkName) {
+    ArenaScope arenaScope(cycleArena); // Free upload buffers on return
     char encryptedTemperature[INPUT_BUFFER_LIMIT] = {0}; // Create array to store encrypted temperature
     char buffer[20]; // Create a character array with a size of 20
-    dtostrf(temperature, 6, 2, buffer); // Convert temperature value to string and store it in buffer
+    temperature.format(buffer, sizeof(buffer)); // Format temperature value with two decimals into buffer
 
     byte temp_enc_iv[N_BLOCK]; // Create array to store temporary initialization vector
     generateNewIV(temp_enc_iv, enc_ivs[8]); // Generate a new IV for encryption
     encryptAndConvertToHex(buffer, encryptedTemperature, temp_enc_iv); // Encrypt temperature value from buffer and convert to hex
 
-    FirebaseJson json; // Create FirebaseJson object to store JSON payload
-    json.set(TEMPERATURE_KEY, encryptedTemperature); // Set temperature field to JSON payload with encrypted data
+    char key[32]; // Create array to store node path key
+    copyFlashString(key, sizeof(key), TEMPERATURE_KEY); // Copy node path key from flash
+
+    JsonWriter json(cycleArena, JSON_PAYLOAD_LIMIT); // Create JsonWriter to serialize payload into arena buffer
+    json.set(key, encryptedTemperature); // Set temperature field to JSON payload with encrypted data
 
     // call setupApiCallWithHistory data function and return its result
-    return setupApiCallWithHistoryData(deviceId, networkName, json, TEMPERATURE_KEY); 
+    return setupApiCallWithHistoryData(deviceId, networkName, json, key, encryptedTemperature); 
 }
 
 // Function to send humidity data to firebase
-bool ApiManager::encryptAndSendHumidity(float humidity, const String& deviceId, const String& networkName) {
+bool ApiManager::encryptAndSendHumidity(const FixedPoint& humidity, const String& deviceId, const String& networkName) {
+    ArenaScope arenaScope(cycleArena); // Free upload buffers on return
     char encryptedHumidity[INPUT_BUFFER_LIMIT] = {0}; // Create array to store encrypted humidity
     char buffer[20]; // Create a character array with a size of 20
-    dtostrf(humidity, 6, 2, buffer); // Convert humidity value to string and store it in buffer
+    humidity.format(buffer, sizeof(buffer)); // Format humidity value with two decimals into buffer
 
     byte temp_enc_iv[N_BLOCK]; // Create array to store temporary initialization vector
     generateNewIV(temp_enc_iv, enc_ivs[15]); // Generate a new IV for encryption
     encryptAndConvertToHex(buffer, encryptedHumidity, temp_enc_iv); // Encrypt humidity value from buffer and convert to hex
 
-    FirebaseJson json; // Create FirebaseJson object to store JSON payload
-    json.set(HUMIDITY_KEY, encryptedHumidity); // Set humidity field to JSON payload with encrypted data
+    char key[32]; // Create array to store node path key
+    copyFlashString(key, sizeof(key), HUMIDITY_KEY); // Copy node path key from flash
+
+    JsonWriter json(cycleArena, JSON_PAYLOAD_LIMIT); // Create JsonWriter to serialize payload into arena buffer
+    json.set(key, encryptedHumidity); // Set humidity field to JSON payload with encrypted data
 
     // call setupApiCallWithHistory data function and return its result
-    return setupApiCallWithHistoryData(deviceId, networkName, json, HUMIDITY_KEY);
+    return setupApiCallWithHistoryData(deviceId, networkName, json, key, encryptedHumidity);
 }
 
 // Function to send air pressure data to firebase
-bool ApiManager::encryptAndSendAirPressure(float airPressure, const String& deviceId, const String& networkName) {
+bool ApiManager::encryptAndSendAirPressure(const FixedPoint& airPressure, const String& deviceId, const String& networkName) {
+    ArenaScope arenaScope(cycleArena); // Free upload buffers on return
     char encryptedAirPressure[INPUT_BUFFER_LIMIT] = {0}; // Create array to store encrypted air pressure
     char buffer[20]; // Create a character array with a size of 20
-    dtostrf(airPressure, 6, 2, buffer); // Convert air pressure value to string and store it in buffer
+    airPressure.format(buffer, sizeof(buffer)); // Format air pressure value with two decimals into buffer
 
     byte temp_enc_iv[N_BLOCK]; // Create array to store temporary initialization vector
     generateNewIV(temp_enc_iv, enc_ivs[16]);  // Generate a new IV for encryption
     encryptAndConvertToHex(buffer, encryptedAirPressure, temp_enc_iv); // Encrypt air pressure value from buffer and convert to hex
 
-    FirebaseJson json; // Create FirebaseJson object to store JSON payload
-    json.set(AIR_PRESSURE_KEY, encryptedAirPressure);
+    char key[32]; // Create array to store node path key
+    copyFlashString(key, sizeof(key), AIR_PRESSURE_KEY); // Copy node path key from flash
+
+    JsonWriter json(cycleArena, JSON_PAYLOAD_LIMIT); // Create JsonWriter to serialize payload into arena buffer
+    json.set(key, encryptedAirPressure);
 
     // call setupApiCallWithHistory data function and return its result
-    return setupApiCallWithHistoryData(deviceId, networkName, json, AIR_PRESSURE_KEY);
+    return setupApiCallWithHistoryData(deviceId, networkName, json, key, encryptedAirPressure);
 }
 
-bool ApiManager::encryptAndSendLuminosity(float luminosity, const String& deviceId, const String& networkName) {
+bool ApiManager::encryptAndSendLuminosity(const FixedPoint& luminosity, const String& deviceId, const String& networkName) {
+    ArenaScope arenaScope(cycleArena); // Free upload buffers on return
     char encryptedLuminosity[INPUT_BUFFER_LIMIT] = {0}; // Create array to store encrypted luminosity
     char buffer[20]; // Create a character array with a size of 20
-    dtostrf(luminosity, 6, 2, buffer); // Convert luminosity value to string and store it in buffer
+    luminosity.format(buffer, sizeof(buffer)); // Format luminosity value with two decimals into buffer
 
     byte temp_enc_iv[N_BLOCK]; // Create array to store temporary initialization vector
     generateNewIV(temp_enc_iv, enc_ivs[17]);  // Generate a new IV for encryption
     encryptAndConvertToHex(buffer, encryptedLuminosity, temp_enc_iv); // Encrypt luminosity value from buffer and convert to hex
 
-    FirebaseJson json; // Create FirebaseJson object to store JSON payload
-    json.set(LUMINOSITY_KEY, encryptedLuminosity); // Set luminosity field to JSON payload with encrypted data
+    char key[32]; // Create array to store node path key
+    copyFlashString(key, sizeof(key), LUMINOSITY_KEY); // Copy node path key from flash
+
+    JsonWriter json(cycleArena, JSON_PAYLOAD_LIMIT); // Create JsonWriter to serialize payload into arena buffer
+    json.set(key, encryptedLuminosity); // Set luminosity field to JSON payload with encrypted data
 
     // call setupApiCallWithHistory data function and return its result
-    return setupApiCallWithHistoryData(deviceId, networkName, json, LUMINOSITY_KEY);
+    return setupApiCallWithHistoryData(deviceId, networkName, json, key, encryptedLuminosity);
 }
 
-bool ApiManager::encryptAndSendSoilMoisture(int soilMoisture, const String& deviceId, const String& networkName) {
+bool ApiManager::encryptAndSendSoilMoisture(int soilMoisture, int plantIndex, const String& deviceId, const String& networkName) {
+    ArenaScope arenaScope(cycleArena); // Free upload buffers on return
     char encryptedSoilMoisture[INPUT_BUFFER_LIMIT] = {0}; // Create array to store encrypted soil moisture
     char buffer[20]; // Create a character array with a size of 20
-    dtostrf(soilMoisture, 6, 2, buffer); // Convert soilMoisture value to string and store it in buffer
+    FixedPoint::fromInt(soilMoisture).format(buffer, sizeof(buffer)); // Format soil moisture value with two decimals into buffer
 
     byte temp_enc_iv[N_BLOCK]; // Create array to store temporary initialization vector
     generateNewIV(temp_enc_iv, enc_ivs[14]);  // Generate a new IV for encryption
     encryptAndConvertToHex(buffer, encryptedSoilMoisture, temp_enc_iv); // Encrypt soil moisture value from buffer and convert to hex
 
-    FirebaseJson json; // Create FirebaseJson object to store JSON payload
-    json.set(SOIL_MOISTURE_KEY, encryptedSoilMoisture); // Set soil moisture field to JSON payload with encrypted data
+    // First plant keeps the original key, others are suffixed with plant index
+    char soilMoistureKey[32];
+    size_t keyLength = copyFlashString(soilMoistureKey, sizeof(soilMoistureKey), SOIL_MOISTURE_KEY);
+    if (plantIndex > 0) {
+        snprintf(soilMoistureKey + keyLength, sizeof(soilMoistureKey) - keyLength, "_%d", plantIndex);
+    }
+
+    JsonWriter json(cycleArena, JSON_PAYLOAD_LIMIT); // Create JsonWriter to serialize payload into arena buffer
+    json.set(soilMoistureKey, encryptedSoilMoisture); // Set soil moisture field to JSON payload with encrypted data
 
     // call setupApiCallWithHistory data function and return its result
-    return setupApiCallWithHistoryData(deviceId, networkName, json, SOIL_MOISTURE_KEY);
+    return setupApiCallWithHistoryData(deviceId, networkName, json, soilMoistureKey, encryptedSoilMoisture);
 }
 
-bool ApiManager::encryptAndSendWaterTankLevel(float waterTankLevel, const String& deviceId, const String& networkName) {
+bool ApiManager::encryptAndSendWaterTankLevel(const FixedPoint& waterTankLevel, const String& deviceId, const String& networkName) {
+    ArenaScope arenaScope(cycleArena); // Free upload buffers on return
     char encryptedWaterTankLevel[INPUT_BUFFER_LIMIT] = {0}; // Create array to store encrypted luminosity
     char buffer[20]; // Create a character array with a size of 20
-    dtostrf(waterTankLevel, 6, 2, buffer); // Convert water tank level value to string and store it in buffer
+    waterTankLevel.format(buffer, sizeof(buffer)); // Format water tank level value with two decimals into buffer
 
     byte temp_enc_iv[N_BLOCK]; // Create array to store temporary initialization vector
     generateNewIV(temp_enc_iv, enc_ivs[19]);  // Generate a new IV for encryption
     encryptAndConvertToHex(buffer, encryptedWaterTankLevel, temp_enc_iv); // Encrypt water tank level value from buffer and convert to hex
 
-    FirebaseJson json; // Create FirebaseJson object to store JSON payload
-    json.set(WATER_TANK_LEVEL_KEY, encryptedWaterTankLevel); // Set water tank level field to JSON payload with encrypted data
+    char key[32]; // Create array to store node path key
+    copyFlashString(key, sizeof(key), WATER_TANK_LEVEL_KEY); // Copy node path key from flash
+
+    JsonWriter json(cycleArena, JSON_PAYLOAD_LIMIT); // Create JsonWriter to serialize payload into arena buffer
+    json.set(key, encryptedWaterTankLevel); // Set water tank level field to JSON payload with encrypted data
 
     // call setupApiCallWithHistory data function and return its result
-    return setupApiCallWithHistoryData(deviceId, networkName, json, WATER_TANK_LEVEL_KEY);
+    return setupApiCallWithHistoryData(deviceId, networkName, json, key, encryptedWaterTankLevel);
 }
 
-bool ApiManager::encryptAndSendLatestWateringTime(const String& currentTime, const String& deviceId, const String& networkName) {
+bool ApiManager::encryptAndSendLatestWateringTime(const char* currentTime, const String& deviceId, const String& networkName) {
+    ArenaScope arenaScope(cycleArena); // Free upload buffers on return
     char encryptedCurrentTime[INPUT_BUFFER_LIMIT] = {0}; // Create array to store encrypted current time
 
     byte temp_enc_iv[N_BLOCK]; // Create array to store temporary initialization vector
     generateNewIV(temp_enc_iv, enc_ivs[20]);  // Generate a new IV for encryption
-    encryptAndConvertToHex(currentTime.c_str(), encryptedCurrentTime, temp_enc_iv); // Encrypt current time value and convert to hex
+    encryptAndConvertToHex(currentTime, encryptedCurrentTime, temp_enc_iv); // Encrypt current time value and convert to hex
+
+    char key[32]; // Create array to store node path key
+    copyFlashString(key, sizeof(key), LATEST_WATERING_TIME_KEY); // Copy node path key from flash
 
-    FirebaseJson json; // Create FirebaseJson object to store JSON payload
-    json.set(LATEST_WATERING_TIME_KEY, encryptedCurrentTime); // Set latest watering time field to JSON payload with encrypted data
+    JsonWriter json(cycleArena, JSON_PAYLOAD_LIMIT); // Create JsonWriter to serialize payload into arena buffer
+    json.set(key, encryptedCurrentTime); // Set latest watering time field to JSON payload with encrypted data
 
     // call setupApiCallWithHistory data function and return its result
-    return setupApiCallWithHistoryData(deviceId, networkName, json, LATEST_WATERING_TIME_KEY);
+    return setupApiCallWithHistoryData(deviceId, networkName, json, key, encryptedCurrentTime);
 }
 
-bool ApiManager::encryptAndSendLatestSensorReadingTime(const String& currentTime, const String& deviceId, const String& networkName) {
+bool ApiManager::encryptAndSendLatestSensorReadingTime(const char* currentTime, const String& deviceId, const String& networkName) {
+    ArenaScope arenaScope(cycleArena); // Free upload buffers on return
     char encryptedCurrentTime[INPUT_BUFFER_LIMIT] = {0}; // Create array to store encrypted current time
 
     byte temp_enc_iv[N_BLOCK]; // Create array to store temporary initialization vector
     generateNewIV(temp_enc_iv, enc_ivs[23]);  // Generate a new IV for encryption
-    encryptAndConvertToHex(currentTime.c_str(), encryptedCurrentTime, temp_enc_iv); // Encrypt current time value and convert to hex
+    encryptAndConvertToHex(currentTime, encryptedCurrentTime, temp_enc_iv); // Encrypt current time value and convert to hex
+
+    char key[32]; // Create array to store node path key
+    copyFlashString(key, sizeof(key), LATEST_SENSOR_READING_TIME_KEY); // Copy node path key from flash
 
-    FirebaseJson json; // Create FirebaseJson object to store JSON payload
-    json.set(LATEST_SENSOR_READING_TIME_KEY, encryptedCurrentTime); // Set latest watering time field to JSON payload with encrypted data
+    JsonWriter json(cycleArena, JSON_PAYLOAD_LIMIT); // Create JsonWriter to serialize payload into arena buffer
+    json.set(key, encryptedCurrentTime); // Set latest watering time field to JSON payload with encrypted data
 
     // call setupApiCallWithHistory data function and return its result
-    return setupApiCallWithHistoryData(deviceId, networkName, json, LATEST_SENSOR_READING_TIME_KEY);
+    return setupApiCallWithHistoryData(deviceId, networkName, json, key, encryptedCurrentTime);
 }
 
-bool ApiManager::encryptAndSendWaterTankRefillNotification(const String& currentTime, const String& deviceId, const String& networkName) {
+bool ApiManager::encryptAndSendWaterTankRefillNotification(const char* currentTime, const String& deviceId, const String& networkName) {
+    ArenaScope arenaScope(cycleArena); // Free upload buffers on return
     char encryptedCurrentTime[INPUT_BUFFER_LIMIT] = {0};  // Create array to store encrypted current time
     char encryptedWifiSSID[INPUT_BUFFER_LIMIT] = {0};  // Create array to store encrypted WiFi SSID
-    byte temp_enc_iv_1[N_BLOCK]; // Create array to store temporary initialization vector
-    byte temp_enc_iv_2[N_BLOCK]; // Create array to store temporary initialization vector
-    generateNewIV(temp_enc_iv_1, enc_ivs[21]);  // Generate a new IV for encryption
-    generateNewIV(temp_enc_iv_2, enc_ivs[22]);  // Generate a new IV for encryption
-    encryptAndConvertToHex(currentTime.c_str(), encryptedCurrentTime, temp_enc_iv_1); // Encrypt current time value and convert to hex
-    encryptAndConvertToHex(networkName.c_str(), encryptedWifiSSID, temp_enc_iv_2); // Encrypt network name value and convert to hex
-    String encryptedWifiSSIDString(encryptedWifiSSID); // Create String object to hold the encrypted WiFi SSID data
-
-    FirebaseJson json; // Create FirebaseJson object to store JSON payload
-    json.set(WATER_TANK_REFILL_NOTIFICATION_KEY, encryptedCurrentTime); // Set water tank refill notification field to JSON payload with encrypted data
-    json.set("notification_read", false); // Set notification read field to JSON payload with encrypted data
+    byte temp_enc_iv[N_BLOCK]; // Create array to store temporary initialization vector
+    generateNewIV(temp_enc_iv, enc_ivs[21]);  // Generate a new IV for encryption
+    encryptAndConvertToHex(currentTime, encryptedCurrentTime, temp_enc_iv); // Encrypt current time value and convert to hex
+    cipherCache.encrypt(CACHED_NOTIFICATION_SSID, networkName.c_str(), encryptedWifiSSID); // Encrypt network name once per SSID
+
+    char key[32]; // Create array to store node path key
+    copyFlashString(key, sizeof(key), WATER_TANK_REFILL_NOTIFICATION_KEY); // Copy node path key from flash
+
+    JsonWriter json(cycleArena, JSON_PAYLOAD_LIMIT); // Create JsonWriter to serialize payload into arena buffer
+    json.set(key, encryptedCurrentTime); // Set water tank refill notification field to JSON payload with encrypted data
+    json.set("notification_read", false); // Set notification read field to JSON payload
 
     // Define node path
-    String nodePath = "notifications/" + getFormattedDate() + encryptedWifiSSIDString + "/" + deviceId + "/" + getCurrentTimeAsString();
+    char formattedDate[FORMATTED_DATE_LENGTH]; // Create array to store formatted date
+    getFormattedDate(formattedDate, sizeof(formattedDate));
+    PathBuilder nodePath;
+    nodePath.add("notifications/").add(formattedDate).add(encryptedWifiSSID).add("/").add(deviceId).add("/").add(currentTime);
 
     // call handleApiCall function and return check for its result
     if (handleApiCall(json, nodePath)) {
@@ -242,3 +305,48 @@ bool ApiManager::encryptAndSendWaterTankRefillNotification(const String& current
         return false; // If request fails return false
     }
 }
+
+// Function to send batch of sensor node readings to firebase under node device ID
+bool ApiManager::encryptAndSendNodeReadings(const char* nodeId, const NodeValue* values, int count, const String& networkName) {
+    ArenaScope arenaScope(cycleArena); // Free upload buffers on return
+    char encryptedValue[INPUT_BUFFER_LIMIT]; // Create array to store encrypted value, reused for every metric
+    char buffer[20]; // Create a character array with a size of 20
+    char key[32]; // Create array to store node path key
+    byte temp_enc_iv[N_BLOCK]; // Create array to store temporary initialization vector
+
+    JsonWriter json(cycleArena, JSON_PAYLOAD_LIMIT); // Create JsonWriter to serialize payload into arena buffer
+    for (int i = 0; i < count; i++) {
+        PGM_P flashKey;
+        int ivIndex;
+        if (!getNodeMetricKey(values[i].metric, flashKey, ivIndex)) {
+            continue; // Unknown metric, node firmware is newer than gateway
+        }
+        copyFlashString(key, sizeof(key), flashKey); // Copy node path key from flash
+        FixedPoint::fromHundredths(values[i].hundredths).format(buffer, sizeof(buffer)); // Format value with two decimals into buffer
+
+        memset(encryptedValue, 0, sizeof(encryptedValue));
+        generateNewIV(temp_enc_iv, enc_ivs[ivIndex]); // Generate a new IV for encryption
+        encryptAndConvertToHex(buffer, encryptedValue, temp_enc_iv); // Encrypt value from buffer and convert to hex
+        json.set(key, encryptedValue); // Set metric field to JSON payload with encrypted data
+    }
+    json.set("gateway", deviceId); // Device which uploaded readings of the node
+
+    // Whole batch of one node is written with one request
+    PathBuilder nodePath;
+    nodePath.add("devices/").add(nodeId);
+    return handleApiCall(json, nodePath);
+}
+
+// Function to resolve node path key and IV index of node metric
+bool ApiManager::getNodeMetricKey(uint8_t metric, PGM_P& key, int& ivIndex) const {
+    // Same keys and IVs as readings of the gateway itself
+    switch (metric) {
+        case NODE_TEMPERATURE: key = TEMPERATURE_KEY; ivIndex = 8; return true;
+        case NODE_HUMIDITY: key = HUMIDITY_KEY; ivIndex = 15; return true;
+        case NODE_AIR_PRESSURE: key = AIR_PRESSURE_KEY; ivIndex = 16; return true;
+        case NODE_SOIL_MOISTURE: key = SOIL_MOISTURE_KEY; ivIndex = 14; return true;
+        case NODE_LUMINOSITY: key = LUMINOSITY_KEY; ivIndex = 17; return true;
+        case NODE_WATER_TANK_LEVEL: key = WATER_TANK_LEVEL_KEY; ivIndex = 19; return true;
+        default: return false;
+    }
+}
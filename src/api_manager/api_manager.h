@@ -13,36 +13,46 @@
 #include "../wifi_module/wifi_module.h"
 #include "../time_module/time_module.h"
 #include "../firebase_module/firebase_module.h"
+#include "../history_module/history_module.h"
+#include "../path_builder/path_builder.h"
+#include "../fixed_point/fixed_point.h"
+#include "../gateway_module/gateway_module.h"
 
 class ApiManager {
 public:
     // API operations
     bool encryptAndSendDeviceRegistration(const String& deviceId, const String& networkName);
     bool encryptAndSendDeviceInfo(const String& deviceId, const String& networkName, const String& localIp);
-    bool encryptAndSendTemperature(float temperature, const String& deviceId, const String& networkName);
-    bool encryptAndSendHumidity(float humidity, const String& deviceId, const String& networkName);
-    bool encryptAndSendAirPressure(float airPressure, const String& deviceId, const String& networkName);
-    bool encryptAndSendSoilMoisture(int soilMoisture, const String& deviceId, const String& networkName);
-    bool encryptAndSendLuminosity(float luminosity, const String& deviceId, const String& networkName);
-    bool encryptAndSendWaterTankLevel(float waterTankLevel, const String& deviceId, const String& networkName);
-    bool encryptAndSendLatestWateringTime(const String& currentTime, const String& deviceId, const String& networkName);
-    bool encryptAndSendLatestSensorReadingTime(const String& currentTime, const String& deviceId, const String& networkName);
-    bool encryptAndSendWaterTankRefillNotification(const String& currentTime, const String& deviceId, const String& networkName);
+    bool encryptAndSendTemperature(const FixedPoint& temperature, const String& deviceId, const String& networkName);
+    bool encryptAndSendHumidity(const FixedPoint& humidity, const String& deviceId, const String& networkName);
+    bool encryptAndSendAirPressure(const FixedPoint& airPressure, const String& deviceId, const String& networkName);
+    bool encryptAndSendSoilMoisture(int soilMoisture, int plantIndex, const String& deviceId, const String& networkName);
+    bool encryptAndSendLuminosity(const FixedPoint& luminosity, const String& deviceId, const String& networkName);
+    bool encryptAndSendWaterTankLevel(const FixedPoint& waterTankLevel, const String& deviceId, const String& networkName);
+    bool encryptAndSendLatestWateringTime(const char* currentTime, const String& deviceId, const String& networkName);
+    bool encryptAndSendLatestSensorReadingTime(const char* currentTime, const String& deviceId, const String& networkName);
+    bool encryptAndSendWaterTankRefillNotification(const char* currentTime, const String& deviceId, const String& networkName);
+    bool encryptAndSendNodeReadings(const char* nodeId, const NodeValue* values, int count, const String& networkName);
 private: 
-    // API node path keys
-    const char* AIR_PRESSURE_KEY = "air_pressure";
-    const char* HUMIDITY_KEY = "humidity";
-    const char* LUMINOSITY_KEY = "luminosity";
-    const char* SOIL_MOISTURE_KEY = "soil_moisture";
-    const char* TEMPERATURE_KEY = "temperature";
-    const char* WATER_TANK_LEVEL_KEY = "water_tank_level";
-    const char* LATEST_WATERING_TIME_KEY = "latest_watering_time";
-    const char* LATEST_SENSOR_READING_TIME_KEY = "latest_sensor_reading_time";
-    const char* WATER_TANK_REFILL_NOTIFICATION_KEY = "refill_water_tank";
+    HistoryModule historyModule; // Daily history buckets
+
+    // API node path keys, kept in flash and defined in api_manager.cpp
+    static const char AIR_PRESSURE_KEY[];
+    static const char HUMIDITY_KEY[];
+    static const char LUMINOSITY_KEY[];
+    static const char SOIL_MOISTURE_KEY[];
+    static const char TEMPERATURE_KEY[];
+    static const char WATER_TANK_LEVEL_KEY[];
+    static const char LATEST_WATERING_TIME_KEY[];
+    static const char LATEST_SENSOR_READING_TIME_KEY[];
+    static const char WATER_TANK_REFILL_NOTIFICATION_KEY[];
 
     // API setup functions
-    bool setupApiCallWithHistoryData(const String& deviceId, const String& networkName, FirebaseJson json, const String& nodePathKey);
-    bool handleApiCall(FirebaseJson json, const String& nodePath);
+    bool setupApiCallWithHistoryData(const String& deviceId, const String& networkName, const JsonWriter& json, const char* nodePathKey, const char* encryptedValue);
+    bool handleApiCall(const JsonWriter& json, const PathBuilder& nodePath);
+
+    // Resolve node path key and IV index of node metric, returns false for unknown metric
+    bool getNodeMetricKey(uint8_t metric, PGM_P& key, int& ivIndex) const;
 };
 
 #endif
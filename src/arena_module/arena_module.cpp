@@ -0,0 +1,83 @@
+/**
+ * File: arena_module.cpp
+ * Author: Joonas Nislin
+ * Date: 19.10.2026
+ * Description: This file contains implementation of ArenaModule.
+ * Provides a bump allocator over memory reserved at boot. Upload buffers are taken from it
+ * instead of the heap, so long uptimes do not fragment the heap that TLS allocations need.
+ * Functions release their buffers with ArenaScope and the owner resets the arena after each cycle.
+ */
+
+#include "arena_module.h"
+
+uint8_t cycleArenaBuffer[CYCLE_ARENA_SIZE] __attribute__((aligned(4))); // Reserved at boot, never freed
+Arena cycleArena(cycleArenaBuffer, sizeof(cycleArenaBuffer));
+
+// Constructor
+Arena::Arena(uint8_t* buffer, size_t capacity) : buffer(buffer), capacity(capacity) {}
+
+// Function for allocating aligned block
+void* Arena::allocate(size_t size) {
+    size_t alignedSize = (size + 3) & ~(size_t)3;
+    if (alignedSize > capacity - used) {
+        failedAllocations++;
+        return nullptr;
+    }
+    void* block = buffer + used;
+    used += alignedSize;
+    allocations++;
+    if (used > highWaterMark) {
+        highWaterMark = used;
+    }
+    return block;
+}
+
+// Function for allocating character buffer
+char* Arena::allocateChars(size_t size) {
+    return (char*)allocate(size);
+}
+
+// Function for getting fill level
+size_t Arena::mark() const {
+    return used;
+}
+
+// Function for freeing allocations made after mark
+void Arena::rewind(size_t mark) {
+    if (mark < used) {
+        used = mark;
+    }
+}
+
+// Function for freeing all allocations
+void Arena::reset() {
+    used = 0;
+}
+
+// Function for getting arena size
+size_t Arena::getCapacity() const {
+    return capacity;
+}
+
+// Function for getting high-water mark
+size_t Arena::getHighWaterMark() const {
+    return highWaterMark;
+}
+
+// Function for getting failed allocation count
+unsigned long Arena::getFailedAllocations() const {
+    return failedAllocations;
+}
+
+// Function for getting number of allocations since boot
+unsigned long Arena::getAllocationCount() const {
+    return allocations;
+}
+
+// Constructor, remembers current fill level
+ArenaScope::ArenaScope(Arena& arena) : arena(arena), savedMark(arena.mark()) {}
+
+// Destructor, frees allocations made in the scope
+ArenaScope::~ArenaScope() {
+    arena.rewind(savedMark);
+}
@@ -0,0 +1,71 @@
+/**
+ * File: arena_module.h
+ * Author: Joonas Nislin
+ * Date: 19.10.2026
+ * Description: This file contains header file of ArenaModule.
+ * Holds declarations for the per-cycle bump arena used for short-lived upload buffers.
+ */
+
+#ifndef ARENA_MODULE_H
+#define ARENA_MODULE_H
+
+#include <ESP8266WiFi.h>
+
+#define CYCLE_ARENA_SIZE 4096 // Bytes reserved at boot for upload work of one cycle
+
+class Arena {
+public:
+    // Use buffer as arena memory
+    Arena(uint8_t* buffer, size_t capacity);
+
+    // Allocate 4-byte aligned block, returns nullptr if arena is exhausted
+    void* allocate(size_t size);
+
+    // Allocate character buffer, returns nullptr if arena is exhausted
+    char* allocateChars(size_t size);
+
+    // Current fill level, can be passed to rewind
+    size_t mark() const;
+
+    // Free everything allocated after mark
+    void rewind(size_t mark);
+
+    // Free everything, called at the end of each cycle
+    void reset();
+
+    // Arena size in bytes
+    size_t getCapacity() const;
+
+    // Highest fill level since boot
+    size_t getHighWaterMark() const;
+
+    // Number of allocations that did not fit
+    unsigned long getFailedAllocations() const;
+
+    // Number of allocations since boot
+    unsigned long getAllocationCount() const;
+
+private:
+    uint8_t* buffer;
+    size_t capacity;
+    size_t used = 0;
+    size_t highWaterMark = 0;
+    unsigned long failedAllocations = 0;
+    unsigned long allocations = 0;
+};
+
+// Rewinds arena to the level it had when the scope was created
+class ArenaScope {
+public:
+    explicit ArenaScope(Arena& arena);
+    ~ArenaScope();
+
+private:
+    Arena& arena;
+    size_t savedMark;
+};
+
+// Global arena for sensor cycle and event sending
+extern Arena cycleArena;
+
+#endif
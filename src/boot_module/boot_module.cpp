@@ -0,0 +1,69 @@
+/**
+ * File: boot_module.cpp
+ * Author: Joonas Nislin
+ * Date: 19.10.2026
+ * Description: This file contains implementation of BootModule.
+ * Provides functionality for measuring time spent in each boot phase and
+ * caching authorization state, so boot does not wait for an authorization round trip.
+ * Uses LittleFS library, file system is mounted by ConfigModule.
+ */
+
+#include <LittleFS.h>
+#include "boot_module.h"
+#include "../log_module/log_module.h"
+
+#define LOG_TAG "boot"
+
+const char* const BOOT_PHASE_NAMES[NUM_BOOT_PHASES] = {"WiFi started", "Local init", "WiFi connected", "Cloud ready", "First upload"};
+
+// Structure of the cache file
+struct BootStateCache {
+    uint32_t magic;
+    uint32_t authorized;
+};
+
+// Function for recording completion time of boot phase
+void BootModule::markPhase(BootPhase phase) {
+    phaseMillis[phase] = millis();
+}
+
+// Function for printing duration of each boot phase
+void BootModule::printReport() const {
+    unsigned long previousMillis = 0;
+    for (int i = 0; i < NUM_BOOT_PHASES; i++) {
+        LOG_INFO("Phase %s: %lu ms", BOOT_PHASE_NAMES[i], phaseMillis[i] - previousMillis);
+        previousMillis = phaseMillis[i];
+    }
+    LOG_INFO("Time to first upload: %lu ms", phaseMillis[BOOT_FIRST_UPLOAD]);
+}
+
+// Function for reading cached authorization state
+bool BootModule::loadAuthorization() {
+    File file = LittleFS.open(CACHE_FILE_PATH, "r");
+    if (!file) {
+        return false;
+    }
+
+    BootStateCache cache;
+    bool valid = file.read((uint8_t*)&cache, sizeof(cache)) == sizeof(cache) && cache.magic == CACHE_MAGIC;
+    file.close();
+    cachedAuthorized = valid && cache.authorized != 0;
+    return cachedAuthorized;
+}
+
+// Function for writing authorization state, flash is only written when state changes
+void BootModule::saveAuthorization(bool authorized) {
+    if (authorized == cachedAuthorized) {
+        return;
+    }
+
+    File file = LittleFS.open(CACHE_FILE_PATH, "w");
+    if (!file) {
+        LOG_ERROR("Failed to write boot state cache");
+        return;
+    }
+    BootStateCache cache = {CACHE_MAGIC, authorized ? 1U : 0U};
+    file.write((const uint8_t*)&cache, sizeof(cache));
+    file.close();
+    cachedAuthorized = authorized;
+}
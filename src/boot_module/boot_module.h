@@ -0,0 +1,47 @@
+/**
+ * File: boot_module.h
+ * Author: Joonas Nislin
+ * Date: 19.10.2026
+ * Description: This file contains header file of BootModule.
+ * Holds function declarations and constants for boot phase timing and cached boot state.
+ */
+
+#ifndef BOOT_MODULE_H
+#define BOOT_MODULE_H
+
+#include <ESP8266WiFi.h>
+
+// Boot phases in the order they complete
+enum BootPhase {
+    BOOT_WIFI_STARTED, // WiFi association started, not waited for
+    BOOT_LOCAL_INIT_DONE, // Sensors, AES and cached configuration ready
+    BOOT_WIFI_CONNECTED, // WiFi connected
+    BOOT_CLOUD_READY, // NTP, Firebase and command stream started
+    BOOT_FIRST_UPLOAD, // First sensor cycle uploaded
+    NUM_BOOT_PHASES
+};
+
+class BootModule {
+public:
+    // Record time since reset when phase completes
+    void markPhase(BootPhase phase);
+
+    // Print time of each phase and time to first upload
+    void printReport() const;
+
+    // Read authorization state of previous boot from flash, false if not cached
+    bool loadAuthorization();
+
+    // Write authorization state to flash if it changed
+    void saveAuthorization(bool authorized);
+
+private:
+    unsigned long phaseMillis[NUM_BOOT_PHASES] = {};
+    bool cachedAuthorized = false;
+
+    // Constants and Configuration Settings
+    const char* CACHE_FILE_PATH = "/boot.bin";
+    const uint32_t CACHE_MAGIC = 0x56534254; // "VSBT"
+};
+
+#endif
@@ -0,0 +1,94 @@
+/**
+ * File: cipher_cache.cpp
+ * Author: Joonas Nislin
+ * Date: 19.10.2026
+ * Description: This file contains implementation of CipherCache.
+ * Provides functionality for encrypting static fields only once:
+ * - Every field always starts from the same IV, so the same plaintext gives the same ciphertext
+ * - SSID, IP address and device ID are set with update(), a changed value drops its entries
+ * - Device name, firmware version and facility are compiled in and never change
+ */
+
+#include "cipher_cache.h"
+#include "../globals/globals.h"
+#include "../log_module/log_module.h"
+
+#define LOG_TAG "cipher"
+
+CipherCache cipherCache;
+
+// IV index of each cached field
+const int CACHED_FIELD_IVS[NUM_CACHED_FIELDS] = {0, 1, 2, 3, 4, 5, 6, 7, 9, 11, 13, 18, 22};
+
+// Function for setting values that change on reconnect
+void CipherCache::update(const String& networkName, const String& localIp, const String& deviceId) {
+    if (strcmp(this->networkName, networkName.c_str()) != 0) {
+        invalidate(this->networkName);
+        snprintf(this->networkName, sizeof(this->networkName), "%s", networkName.c_str());
+    }
+    if (strcmp(this->localIp, localIp.c_str()) != 0) {
+        invalidate(this->localIp);
+        snprintf(this->localIp, sizeof(this->localIp), "%s", localIp.c_str());
+    }
+    if (strcmp(this->deviceId, deviceId.c_str()) != 0) {
+        invalidate(this->deviceId);
+        snprintf(this->deviceId, sizeof(this->deviceId), "%s", deviceId.c_str());
+    }
+}
+
+// Function for encrypting field, cached ciphertext is used when plaintext matches its source
+void CipherCache::encrypt(CachedField field, const char* plaintext, char* encryptedData) {
+    // Cached entry is only valid for the value it was encrypted from
+    const char* source = getSource(field);
+    bool cacheable = strcmp(plaintext, source) == 0 && strlen(plaintext) < 3 * N_BLOCK;
+    if (cacheable && valid[field]) {
+        strcpy(encryptedData, entries[field]);
+        stats.hits++;
+        return;
+    }
+
+    byte temp_enc_iv[N_BLOCK]; // Create array to store temporary initialization vector
+    generateNewIV(temp_enc_iv, enc_ivs[CACHED_FIELD_IVS[field]]); // Generate a new IV for encryption
+    encryptAndConvertToHex(plaintext, encryptedData, temp_enc_iv); // Encrypt value and convert to hex
+
+    if (cacheable) {
+        strcpy(entries[field], encryptedData);
+        valid[field] = true;
+        stats.misses++;
+    } else {
+        stats.bypasses++;
+    }
+}
+
+// Function for getting current source value of field
+const char* CipherCache::getSource(CachedField field) const {
+    switch (field) {
+        case CACHED_FIRMWARE_VERSION: return FIRMWARE_VERSION;
+        case CACHED_DEVICE_NAME:
+        case CACHED_REGISTRATION_DEVICE_NAME:
+        case CACHED_EVENT_HOSTNAME: return DEVICE_NAME;
+        case CACHED_IP_ADDRESS: return localIp;
+        case CACHED_DEVICE_ID:
+        case CACHED_REGISTRATION_DEVICE_ID: return deviceId;
+        case CACHED_EVENT_FACILITY: return DEVICE;
+        default: return networkName; // SSID fields
+    }
+}
+
+// Function for dropping entries encrypted from source
+void CipherCache::invalidate(const char* source) {
+    for (int i = 0; i < NUM_CACHED_FIELDS; i++) {
+        if (valid[i] && getSource((CachedField)i) == source) {
+            valid[i] = false;
+            stats.invalidations++;
+        }
+    }
+}
+
+// Function for printing counters and encryptions since previous print
+void CipherCache::printStats() {
+    unsigned long encryptions = getEncryptionCount();
+    LOG_INFO("Encryptions: %lu since previous report, cache %lu hits, %lu misses, %lu bypasses, %lu invalidations",
+             encryptions - previousEncryptions, stats.hits, stats.misses, stats.bypasses, stats.invalidations);
+    previousEncryptions = encryptions;
+}
@@ -0,0 +1,72 @@
+/**
+ * File: cipher_cache.h
+ * Author: Joonas Nislin
+ * Date: 19.10.2026
+ * Description: This file contains header file of CipherCache.
+ * Holds declarations for keeping ciphertext of values that only change on reconnect or reflash.
+ */
+
+#ifndef CIPHER_CACHE_H
+#define CIPHER_CACHE_H
+
+#include <ESP8266WiFi.h>
+#include "../aes_module/aes_module.h"
+
+#define CIPHER_CACHE_LENGTH (2 * 3 * N_BLOCK + 1) // Hex length of up to three blocks, longer values are not cached
+
+// Cached fields, each one is encrypted with its own IV
+enum CachedField {
+    CACHED_FIRMWARE_VERSION, // Device info, enc_ivs[0]
+    CACHED_DEVICE_NAME, // Device info, enc_ivs[1]
+    CACHED_IP_ADDRESS, // Device info, enc_ivs[2]
+    CACHED_SSID, // Device info, enc_ivs[3]
+    CACHED_DEVICE_ID, // Device info, enc_ivs[4]
+    CACHED_REGISTRATION_SSID, // Device registration, enc_ivs[5]
+    CACHED_REGISTRATION_DEVICE_ID, // Device registration, enc_ivs[6]
+    CACHED_REGISTRATION_DEVICE_NAME, // Device registration, enc_ivs[7]
+    CACHED_EVENT_HOSTNAME, // Event, enc_ivs[9]
+    CACHED_EVENT_FACILITY, // Event, enc_ivs[11]
+    CACHED_EVENT_SSID, // Event, enc_ivs[13]
+    CACHED_HISTORY_SSID, // History path, enc_ivs[18]
+    CACHED_NOTIFICATION_SSID, // Notification path, enc_ivs[22]
+    NUM_CACHED_FIELDS
+};
+
+// Structure to represent cache counters for diagnostics
+struct CipherCacheStats {
+    unsigned long hits; // Ciphertext copied from cache
+    unsigned long misses; // Value encrypted and stored
+    unsigned long bypasses; // Value differs from cached source or is too long, encrypted every time
+    unsigned long invalidations; // Entries dropped because source value changed
+};
+
+class CipherCache {
+public:
+    // Set values that change on reconnect, entries encrypted from changed values are dropped
+    void update(const String& networkName, const String& localIp, const String& deviceId);
+
+    // Encrypt plaintext of field into encryptedData, cached ciphertext is copied when plaintext matches its source
+    void encrypt(CachedField field, const char* plaintext, char* encryptedData);
+
+    // Print counters and encryptions since previous print
+    void printStats();
+
+private:
+    char networkName[33] = ""; // SSID is at most 32 characters
+    char localIp[16] = "";
+    char deviceId[18] = "";
+    char entries[NUM_CACHED_FIELDS][CIPHER_CACHE_LENGTH];
+    bool valid[NUM_CACHED_FIELDS] = {false};
+    CipherCacheStats stats = {0, 0, 0, 0};
+    unsigned long previousEncryptions = 0;
+
+    // Get current source value of field
+    const char* getSource(CachedField field) const;
+
+    // Drop entries encrypted from source
+    void invalidate(const char* source);
+};
+
+extern CipherCache cipherCache;
+
+#endif
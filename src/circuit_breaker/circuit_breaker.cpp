@@ -0,0 +1,136 @@
+/**
+ * File: circuit_breaker.cpp
+ * Author: Joonas Nislin
+ * Date: 19.10.2026
+ * Description: This file contains implementation of CircuitBreaker.
+ * Provides functionality for uploads during backend outages:
+ * - Failed upload is retried with exponential backoff and full jitter, so devices do not retry in step
+ * - Consecutive failed uploads open the breaker, uploads are then rejected without touching the network
+ * - Open breaker lets one probe through after a jittered interval that doubles on every failed probe
+ * - Failure events are not queued while breaker is open, a single summary event is queued when it closes
+ */
+
+#include "circuit_breaker.h"
+#include "../globals/globals.h"
+#include "../log_module/log_module.h"
+
+#define LOG_TAG "breaker"
+
+CircuitBreaker uploadBreaker;
+
+const char* const BREAKER_STATE_NAMES[] = {"closed", "open", "half-open"};
+
+// Function for checking if upload may go to network
+bool CircuitBreaker::allowRequest() {
+    if (state == BREAKER_OPEN && (long)(millis() - probeAtMillis) >= 0) {
+        state = BREAKER_HALF_OPEN; // Next upload is the probe
+    }
+    if (state == BREAKER_OPEN) {
+        stats.rejected++;
+        rejectedInOutage++;
+        return false;
+    }
+    return true;
+}
+
+// Function for checking if upload would be allowed
+bool CircuitBreaker::canRequest() const {
+    return state != BREAKER_OPEN || (long)(millis() - probeAtMillis) >= 0;
+}
+
+// Function for accounting upload result
+void CircuitBreaker::recordResult(bool success) {
+    if (success) {
+        if (state != BREAKER_CLOSED) {
+            // Outage is over, summary is queued from main loop
+            lastOutageMillis = millis() - openedMillis;
+            lastOutageRejected = rejectedInOutage;
+            lastOutageSuppressed = suppressedInOutage;
+            LOG_INFO("Upload breaker closed");
+        }
+        state = BREAKER_CLOSED;
+        consecutiveFailures = 0;
+        openInterval = 0;
+        return;
+    }
+
+    consecutiveFailures++;
+    if (state == BREAKER_HALF_OPEN || consecutiveFailures >= FAILURE_THRESHOLD) {
+        open();
+    }
+}
+
+// Function for waiting before retry, delay is random between zero and exponential backoff
+bool CircuitBreaker::backoff(int attempt) {
+    if (attempt >= MAX_ATTEMPTS || state != BREAKER_CLOSED) {
+        return false; // Probe is never retried, its failure reopens breaker
+    }
+    unsigned long ceiling = RETRY_BASE_DELAY << (attempt - 1);
+    if (ceiling > RETRY_MAX_DELAY) {
+        ceiling = RETRY_MAX_DELAY;
+    }
+    delay(random(ceiling + 1));
+    stats.retries++;
+    return true;
+}
+
+// Function for counting suppressed failure event
+void CircuitBreaker::recordSuppressedEvent() {
+    stats.suppressedEvents++;
+    suppressedInOutage++;
+}
+
+// Function for checking if breaker is open
+bool CircuitBreaker::isOpen() const {
+    return state == BREAKER_OPEN;
+}
+
+// Function for getting breaker state
+BreakerState CircuitBreaker::getState() const {
+    return state;
+}
+
+// Function for getting breaker counters
+const BreakerStats& CircuitBreaker::getStats() const {
+    return stats;
+}
+
+// Function for printing state and counters
+void CircuitBreaker::printStats() const {
+    LOG_INFO("Upload breaker: %s, consecutive failures: %d, retries: %lu, opens: %lu, rejected: %lu, suppressed events: %lu",
+             BREAKER_STATE_NAMES[state], consecutiveFailures, (unsigned long)stats.retries,
+             (unsigned long)stats.opens, (unsigned long)stats.rejected, (unsigned long)stats.suppressedEvents);
+}
+
+// Function for queueing outage summary event
+void CircuitBreaker::reportPending() {
+    if (lastOutageMillis == 0) {
+        return;
+    }
+    char message[INPUT_BUFFER_LIMIT];
+    // At most 62 characters, so message fits one encrypted event field even with 10 digit counters
+    snprintf(message, sizeof(message), "Paused %lus, %lu rejected, %lu suppressed",
+             lastOutageMillis / 1000, lastOutageRejected, lastOutageSuppressed);
+    lastOutageMillis = 0;
+    handleEvent(WARNING, message, UPLOAD_BREAKER);
+}
+
+// Function for opening breaker
+void CircuitBreaker::open() {
+    if (state == BREAKER_CLOSED) {
+        // New outage
+        openedMillis = millis();
+        rejectedInOutage = 0;
+        suppressedInOutage = 0;
+        openInterval = MIN_OPEN_INTERVAL;
+    } else {
+        openInterval = openInterval * 2 > MAX_OPEN_INTERVAL ? MAX_OPEN_INTERVAL : openInterval * 2;
+    }
+    state = BREAKER_OPEN;
+    stats.opens++;
+
+    // Probe somewhere in the second half of the interval so devices behind one router spread out
+    probeAtMillis = millis() + openInterval / 2 + random(openInterval / 2 + 1);
+
+    LOG_WARNING("Upload breaker open, next probe in %lu s", (probeAtMillis - millis()) / 1000);
+}
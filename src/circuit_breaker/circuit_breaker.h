@@ -0,0 +1,86 @@
+/**
+ * File: circuit_breaker.h
+ * Author: Joonas Nislin
+ * Date: 19.10.2026
+ * Description: This file contains header file of CircuitBreaker.
+ * Holds function declarations and constants for upload retries and pausing uploads during backend outages.
+ */
+
+#ifndef CIRCUIT_BREAKER_H
+#define CIRCUIT_BREAKER_H
+
+#include <ESP8266WiFi.h>
+
+// Breaker states
+enum BreakerState {
+    BREAKER_CLOSED, // Uploads pass
+    BREAKER_OPEN, // Uploads are rejected without network access
+    BREAKER_HALF_OPEN // One probe upload passes, its result closes or reopens breaker
+};
+
+// Structure to represent breaker counters for diagnostics
+struct BreakerStats {
+    unsigned long retries; // Attempts after first failed attempt
+    unsigned long opens; // Transitions to open
+    unsigned long rejected; // Uploads rejected while open
+    unsigned long suppressedEvents; // Failure events not queued while open
+};
+
+class CircuitBreaker {
+public:
+    // Check if upload may go to network, moves open breaker to half-open when probe is due
+    bool allowRequest();
+
+    // Check without changing state if upload would be allowed
+    bool canRequest() const;
+
+    // Account result of upload, including its retries
+    void recordResult(bool success);
+
+    // Wait before retry attempt, returns false when attempts are used up
+    bool backoff(int attempt);
+
+    // Count failure event that was not queued
+    void recordSuppressedEvent();
+
+    // Check if breaker is open
+    bool isOpen() const;
+
+    BreakerState getState() const;
+    const BreakerStats& getStats() const;
+
+    // Print state and counters
+    void printStats() const;
+
+    // Queue summary event if breaker closed after an outage, called from main loop
+    void reportPending();
+
+private:
+    BreakerState state = BREAKER_CLOSED;
+    int consecutiveFailures = 0;
+    unsigned long openedMillis = 0; // Time of first open in current outage
+    unsigned long probeAtMillis = 0; // Time when next probe is allowed
+    unsigned long openInterval = 0; // Current wait between probes
+    unsigned long rejectedInOutage = 0;
+    unsigned long suppressedInOutage = 0;
+    unsigned long lastOutageMillis = 0; // Length of last finished outage, 0 if reported
+    unsigned long lastOutageRejected = 0;
+    unsigned long lastOutageSuppressed = 0;
+    BreakerStats stats = {0, 0, 0, 0};
+
+    // Open breaker and schedule next probe with jittered interval
+    void open();
+
+    // Constants and Configuration Settings
+    const int MAX_ATTEMPTS = 3; // Attempts per upload
+    const unsigned long RETRY_BASE_DELAY = 500; // Milliseconds before first retry
+    const unsigned long RETRY_MAX_DELAY = 4000; // Cap for retry delay
+    const int FAILURE_THRESHOLD = 5; // Consecutive failed uploads that open breaker
+    const unsigned long MIN_OPEN_INTERVAL = 60L * 1000L; // 1 minute before first probe
+    const unsigned long MAX_OPEN_INTERVAL = 30L * 60L * 1000L; // 30 minutes between probes at most
+};
+
+// Breaker shared by all uploads
+extern CircuitBreaker uploadBreaker;
+
+#endif
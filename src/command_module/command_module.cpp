@@ -0,0 +1,245 @@
+/**
+ * File: command_module.cpp
+ * Author: Joonas Nislin
+ * Date: 19.10.2026
+ * Description: This file contains implementation of CommandModule.
+ * Provides functionality for receiving commands from app through one server-sent events stream
+ * on commands/<deviceId>. Each command node has fields:
+ * - type: water_now, read_now, set_interval or reboot
+ * - plant: plant index for water_now
+ * - value: interval in seconds for set_interval
+ * - created: epoch time in seconds when command was created
+ * Executed commands are acknowledged to command_acks/<deviceId>/<commandId> and removed.
+ * A command is executed at most once:
+ * - Ids of executed commands are kept in a ring, a command replayed by stream reconnect is skipped
+ * - Failed deletion is retried from poll, so the command does not stay in the snapshot
+ * - A snapshot command that already has an acknowledgement, e.g. from before reboot, is only removed
+ * Uses FirebaseESP8266 library.
+ */
+
+#include "command_module.h"
+#include "../globals/globals.h"
+#include "../path_builder/path_builder.h"
+#include "../log_module/log_module.h"
+
+#define LOG_TAG "command"
+
+// Command types
+const char COMMAND_WATER_NOW[] PROGMEM = "water_now";
+const char COMMAND_READ_NOW[] PROGMEM = "read_now";
+const char COMMAND_SET_INTERVAL[] PROGMEM = "set_interval";
+const char COMMAND_REBOOT[] PROGMEM = "reboot";
+
+// Function for opening command stream
+void CommandModule::begin(const String& deviceId) {
+    this->deviceId = deviceId;
+    previousStreamAttemptMillis = millis();
+    // Server does not negotiate smaller records, so receive buffer must hold a full record of the
+    // stream payload. 4 KB covers stream events, 1 KB for the small requests sent on this connection.
+    streamData.setBSSLBufferSize(4096, 1024);
+
+    PathBuilder streamPath;
+    streamPath.add("commands/").add(deviceId);
+    streamOpen = Firebase.beginStream(streamData, streamPath.c_str());
+    if (streamOpen) {
+        LOG_INFO("Command stream opened");
+    } else {
+        LOG_ERROR("Failed to open command stream");
+    }
+}
+
+// Function for reading stream and returning next pending command
+bool CommandModule::poll(Command& command) {
+    if (!streamOpen) {
+        // Retry opening the stream every now and then
+        if (millis() - previousStreamAttemptMillis >= STREAM_RETRY_INTERVAL) {
+            begin(deviceId);
+        }
+    } else if (!Firebase.readStream(streamData)) {
+        LOG_WARNING("Failed to read command stream");
+    } else if (streamData.streamAvailable()) {
+        handleStreamEvent();
+    }
+    if (streamOpen) {
+        retryRemovals();
+    }
+
+    if (numPending == 0) {
+        return false; // Nothing to execute
+    }
+
+    // Take the oldest pending command
+    command = pendingCommands[0];
+    for (int i = 1; i < numPending; i++) {
+        pendingCommands[i - 1] = pendingCommands[i];
+    }
+    numPending--;
+    return true;
+}
+
+// Function for handling one stream event
+void CommandModule::handleStreamEvent() {
+    String path = streamData.dataPath();
+
+    // Deletions, including removal of acknowledged commands, carry no command
+    if (streamData.dataType() != "json") {
+        return;
+    }
+
+    if (path == "/") {
+        // Initial snapshot when stream opens, holds commands written while the device was offline
+        addSnapshotCommands(streamData.jsonObject());
+    } else if (path.indexOf('/', 1) < 0) {
+        // New command at /<commandId>, parse it straight from the stream payload
+        Command command;
+        command.id = path.substring(1);
+        command.receivedMillis = millis();
+        parseCommand(streamData.jsonObject(), command);
+        addPending(command);
+    }
+}
+
+// Function for taking commands from initial stream snapshot
+void CommandModule::addSnapshotCommands(FirebaseJson& snapshot) {
+    // Snapshot is {"<commandId>": {...}, ...}, command fields are values so only commands are objects
+    Command commands[MAX_PENDING_COMMANDS];
+    int numCommands = 0;
+    size_t length = snapshot.iteratorBegin();
+    for (size_t i = 0; i < length && numCommands < MAX_PENDING_COMMANDS; i++) {
+        int type = 0;
+        String key;
+        String value;
+        snapshot.iteratorGet(i, type, key, value);
+        if (type != FirebaseJson::JSON_OBJECT) {
+            continue;
+        }
+        FirebaseJson commandJson;
+        commandJson.setJsonData(value);
+        commands[numCommands].id = key;
+        commands[numCommands].receivedMillis = millis();
+        parseCommand(commandJson, commands[numCommands]);
+        numCommands++;
+    }
+    snapshot.iteratorEnd();
+
+    // Acknowledgement reads reuse firebaseData, so they are done after the snapshot is parsed
+    for (int i = 0; i < numCommands; i++) {
+        if (!wasExecuted(commands[i].id) && isAcknowledged(commands[i].id)) {
+            LOG_WARNING("Command %s was executed before, removing it", commands[i].id.c_str());
+            removeCommand(commands[i].id);
+            continue;
+        }
+        addPending(commands[i]);
+    }
+}
+
+// Function for parsing command fields
+void CommandModule::parseCommand(FirebaseJson& json, Command& command) {
+    FirebaseJsonData data;
+    command.type = json.get(data, "type") && data.success ? data.stringValue : String("");
+    command.plant = json.get(data, "plant") && data.success ? data.intValue : 0;
+    command.value = json.get(data, "value") && data.success ? data.intValue : 0;
+    command.created = json.get(data, "created") && data.success ? (unsigned long)data.intValue : 0;
+}
+
+// Function for adding command to pending list
+void CommandModule::addPending(const Command& command) {
+    if (wasExecuted(command.id)) {
+        return; // Replayed by stream reconnect before its deletion went through
+    }
+    for (int i = 0; i < numPending; i++) {
+        if (pendingCommands[i].id == command.id) {
+            return; // Already waiting for execution
+        }
+    }
+    if (numPending < MAX_PENDING_COMMANDS) {
+        pendingCommands[numPending++] = command;
+    } else {
+        LOG_WARNING("Command queue is full, command not enqueued");
+    }
+}
+
+// Function for acknowledging executed command
+void CommandModule::acknowledge(const Command& command, CommandStatus status) {
+    ArenaScope arenaScope(cycleArena); // Free payload buffer on return
+    unsigned long latencyMillis = millis() - command.receivedMillis;
+    String executedTime = getCurrentTimeAsString(); // Also refreshes epoch time
+    unsigned long executed = getCurrentEpochTime();
+
+    // Print latency from stream event to executed action
+    LOG_INFO("Command %s executed in %lu ms", command.type.c_str(), latencyMillis);
+
+    JsonWriter json(cycleArena, JSON_PAYLOAD_LIMIT); // Create JsonWriter to serialize payload into arena buffer
+    json.set("type", command.type);
+    json.set("status", status == COMMAND_OK ? "ok" : (status == COMMAND_UNAUTHORIZED ? "unauthorized" : "failed"));
+    json.set("executed", executedTime);
+    json.set("latency_ms", (int)latencyMillis);
+    if (command.created > 0 && executed >= command.created) {
+        json.set("end_to_end_latency_s", (int)(executed - command.created));
+    }
+
+    // Remember command before any request, so a failed acknowledgement or deletion never runs it again
+    ExecutedCommand& slot = executedCommands[executedHead];
+    executedHead = (executedHead + 1) % EXECUTED_COMMAND_HISTORY;
+    slot.id = command.id;
+    slot.removed = false;
+
+    PathBuilder ackPath;
+    ackPath.add("command_acks/").add(deviceId).add("/").add(command.id);
+    if (!sendFirebaseData(json, ackPath)) {
+        LOG_ERROR("Failed to acknowledge command");
+    }
+
+    // Remove handled command even without acknowledgement, executing it again after reboot is worse
+    slot.removed = removeCommand(command.id);
+}
+
+// Function for checking if command was executed since boot
+bool CommandModule::wasExecuted(const String& id) const {
+    for (int i = 0; i < EXECUTED_COMMAND_HISTORY; i++) {
+        if (executedCommands[i].id.length() > 0 && executedCommands[i].id == id) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Function for checking if command has an acknowledgement
+bool CommandModule::isAcknowledged(const String& id) {
+    PathBuilder ackPath;
+    ackPath.add("command_acks/").add(deviceId).add("/").add(id);
+    if (ackPath.overflowed()) {
+        return false; // Cut off path would read acknowledgement of another node
+    }
+    return Firebase.getShallowData(firebaseData, ackPath.c_str()) && firebaseData.dataType() != "null";
+}
+
+// Function for deleting command node
+bool CommandModule::removeCommand(const String& id) {
+    PathBuilder commandPath;
+    commandPath.add("commands/").add(deviceId).add("/").add(id);
+    if (commandPath.overflowed()) {
+        LOG_ERROR("Command path cut off, %s not removed", id.c_str());
+        return true; // Never delete parent node, retrying does not help
+    }
+    if (!Firebase.deleteNode(firebaseData, commandPath.c_str())) {
+        LOG_WARNING("Failed to remove command %s, retrying later", id.c_str());
+        return false;
+    }
+    return true;
+}
+
+// Function for retrying deletion of executed commands
+void CommandModule::retryRemovals() {
+    if (millis() - previousRemoveAttemptMillis < REMOVE_RETRY_INTERVAL) {
+        return;
+    }
+    previousRemoveAttemptMillis = millis();
+    for (int i = 0; i < EXECUTED_COMMAND_HISTORY; i++) {
+        ExecutedCommand& executed = executedCommands[i];
+        if (executed.id.length() > 0 && !executed.removed) {
+            executed.removed = removeCommand(executed.id);
+            return; // One request per call keeps loop responsive
+        }
+    }
+}
@@ -0,0 +1,98 @@
+/**
+ * File: command_module.h
+ * Author: Joonas Nislin
+ * Date: 19.10.2026
+ * Description: This file contains header file of CommandModule.
+ * Holds function declarations and constants for remote commands received through firebase stream.
+ */
+
+#ifndef COMMAND_MODULE_H
+#define COMMAND_MODULE_H
+
+#include <ESP8266WiFi.h>
+#include <FirebaseESP8266.h>
+
+// Command types, kept in flash and defined in command_module.cpp
+extern const char COMMAND_WATER_NOW[];
+extern const char COMMAND_READ_NOW[];
+extern const char COMMAND_SET_INTERVAL[];
+extern const char COMMAND_REBOOT[];
+
+// Structure to represent a command written by the app to commands/<deviceId>/<commandId>
+struct Command {
+    String id; // Key of the command node
+    String type; // One of command types
+    int plant; // Plant index for water_now
+    long value; // Interval in seconds for set_interval
+    unsigned long created; // Epoch time (seconds) when the app created the command, 0 if not set
+    unsigned long receivedMillis; // Local time when the command arrived from stream
+};
+
+// Result of command written to acknowledgement
+enum CommandStatus {
+    COMMAND_OK,
+    COMMAND_FAILED,
+    COMMAND_UNAUTHORIZED // Device is not authorized yet, command was not executed
+};
+
+// Structure to represent a command that was already executed, kept so it is never executed twice
+struct ExecutedCommand {
+    String id; // Key of the command node, empty for unused slot
+    bool removed = true; // Command node was deleted, otherwise deletion is retried
+};
+
+const int MAX_PENDING_COMMANDS = 4; // Maximum number of commands waiting for execution
+const int EXECUTED_COMMAND_HISTORY = 8; // Executed command ids remembered since boot
+
+class CommandModule {
+public:
+    // Open stream on commands/<deviceId>
+    void begin(const String& deviceId);
+
+    // Read stream and return next pending command if there is one
+    bool poll(Command& command);
+
+    // Write acknowledgement with execution timestamp and remove handled command
+    void acknowledge(const Command& command, CommandStatus status);
+
+private:
+    FirebaseData streamData; // Stream needs its own connection next to firebaseData
+    String deviceId;
+    Command pendingCommands[MAX_PENDING_COMMANDS]; // Commands waiting for execution
+    int numPending = 0;
+    ExecutedCommand executedCommands[EXECUTED_COMMAND_HISTORY]; // Ring of latest executed commands
+    int executedHead = 0; // Next slot overwritten
+    bool streamOpen = false;
+
+    // Handle one stream event
+    void handleStreamEvent();
+
+    // Add command to pending list, ignoring duplicates and commands already executed
+    void addPending(const Command& command);
+
+    // Take commands from initial stream snapshot, they were written while the device was offline
+    void addSnapshotCommands(FirebaseJson& snapshot);
+
+    // Check if command was executed since boot
+    bool wasExecuted(const String& id) const;
+
+    // Check if command was acknowledged before, e.g. before reboot when its deletion failed
+    bool isAcknowledged(const String& id);
+
+    // Delete command node, returns false if deletion failed
+    bool removeCommand(const String& id);
+
+    // Retry deletion of executed commands whose deletion failed
+    void retryRemovals();
+
+    // Parse command fields from JSON
+    void parseCommand(FirebaseJson& json, Command& command);
+
+    // Constants and Configuration Settings
+    const unsigned long STREAM_RETRY_INTERVAL = 30L * 1000L; // 30 seconds
+    const unsigned long REMOVE_RETRY_INTERVAL = 30L * 1000L; // 30 seconds between deletion retries
+    unsigned long previousStreamAttemptMillis = 0;
+    unsigned long previousRemoveAttemptMillis = 0;
+};
+
+#endif
@@ -0,0 +1,228 @@
+/**
+ * File: config_module.cpp
+ * Author: Joonas Nislin
+ * Date: 19.10.2026
+ * Description: This file contains implementation of ConfigModule.
+ * Provides functionality for reading device configuration from config/<deviceId> node in firebase.
+ * Configuration is cached in flash so boot does not need a network round trip.
+ * Only the version field is fetched on sync, full node is downloaded when version changes.
+ * Remote node format (missing fields keep their current value):
+ * - version: integer, increase after every change
+ * - sensor_interval_s, soil_moisture_interval_s, watering_sequence_s: integers in seconds
+ * - min_sensor_interval_s, max_sensor_interval_s: bounds of adaptive sampling in seconds
+ * - minimum_water_tank_level: distance to water surface in cm
+ * - plant_<index>/soil_wet_value, plant_<index>/soil_dry_value: thresholds in 0-1023 scale
+ * Uses LittleFS and FirebaseESP8266 libraries.
+ */
+
+#include <LittleFS.h>
+#include "config_module.h"
+#include "../../config/config.h" // Include configuration file
+#include "../firebase_module/firebase_module.h"
+#include "../path_builder/path_builder.h"
+#include "../watchdog_module/watchdog_module.h"
+#include "../log_module/log_module.h"
+
+#define LOG_TAG "config"
+
+// Structure of the cache file header
+struct ConfigCacheHeader {
+    uint32_t magic;
+    uint32_t size;
+    uint32_t checksum;
+};
+
+// Function for setting defaults and loading cached configuration
+void ConfigModule::begin(const DeviceConfig& defaults, int plantCount) {
+    this->plantCount = plantCount < CONFIG_MAX_PLANTS ? plantCount : CONFIG_MAX_PLANTS;
+    current = defaults;
+
+    if (!LittleFS.begin()) {
+        LOG_ERROR("Failed to mount flash file system, using default configuration");
+        return;
+    }
+
+    DeviceConfig cached;
+    if (loadFromFlash(cached) && validate(cached)) {
+        current = cached;
+        LOG_INFO("Using cached configuration version %lu", (unsigned long)current.version);
+    } else {
+        LOG_INFO("No cached configuration, using default configuration");
+    }
+}
+
+// Function for syncing configuration with firebase
+bool ConfigModule::sync(const String& deviceId) {
+    WatchdogScope watchdogScope(STAGE_FIREBASE_READ);
+    // Fetch only the version number, unchanged configuration costs no payload transfer
+    PathBuilder versionPath;
+    versionPath.add("config/").add(deviceId).add("/version");
+    if (!Firebase.getInt(firebaseData, versionPath.c_str())) {
+        return false; // Node missing or request failed, keep current configuration
+    }
+    uint32_t remoteVersion = (uint32_t)firebaseData.intData();
+    if (remoteVersion == current.version) {
+        return false; // Configuration is up to date
+    }
+
+    DeviceConfig fetched = current;
+    if (!fetchRemoteConfig(deviceId, fetched)) {
+        return false;
+    }
+    fetched.version = remoteVersion;
+
+    if (!validate(fetched)) {
+        LOG_WARNING("Remote configuration is invalid, keeping current configuration");
+        return false;
+    }
+
+    current = fetched;
+    saveToFlash(current);
+    LOG_INFO("Configuration updated to version %lu", (unsigned long)current.version);
+    return true;
+}
+
+// Function for getting currently active configuration
+const DeviceConfig& ConfigModule::get() const {
+    return current;
+}
+
+// Function for overriding sensor interval
+bool ConfigModule::setSensorInterval(unsigned long sensorInterval) {
+    DeviceConfig updated = current;
+    updated.sensorInterval = sensorInterval;
+    if (!validate(updated)) {
+        return false;
+    }
+    current = updated;
+    saveToFlash(current); // Keep the override over reboot
+    return true;
+}
+
+// Function for reading configuration node from firebase
+bool ConfigModule::fetchRemoteConfig(const String& deviceId, DeviceConfig& config) {
+    PathBuilder nodePath;
+    nodePath.add("config/").add(deviceId);
+    if (!Firebase.getJSON(firebaseData, nodePath.c_str())) {
+        return false;
+    }
+
+    FirebaseJson& json = firebaseData.jsonObject();
+    FirebaseJsonData data;
+
+    if (json.get(data, "sensor_interval_s") && data.success) {
+        config.sensorInterval = secondsToMillis(data.intValue);
+    }
+    if (json.get(data, "min_sensor_interval_s") && data.success) {
+        config.minSensorInterval = secondsToMillis(data.intValue);
+    }
+    if (json.get(data, "max_sensor_interval_s") && data.success) {
+        config.maxSensorInterval = secondsToMillis(data.intValue);
+    }
+    if (json.get(data, "soil_moisture_interval_s") && data.success) {
+        config.soilMoistureInterval = secondsToMillis(data.intValue);
+    }
+    if (json.get(data, "watering_sequence_s") && data.success) {
+        config.wateringSequence = secondsToMillis(data.intValue);
+    }
+    if (json.get(data, "minimum_water_tank_level") && data.success) {
+        config.minimumWaterTankLevel = data.floatValue;
+    }
+
+    // Plant specific thresholds
+    for (int i = 0; i < plantCount; i++) {
+        char key[40];
+        snprintf(key, sizeof(key), "plant_%d/soil_wet_value", i);
+        if (json.get(data, key) && data.success) {
+            config.plants[i].soilWetValue = data.intValue;
+        }
+        snprintf(key, sizeof(key), "plant_%d/soil_dry_value", i);
+        if (json.get(data, key) && data.success) {
+            config.plants[i].soilDryValue = data.intValue;
+        }
+    }
+    return true;
+}
+
+// Function for converting seconds to milliseconds, out of range value gives 0 so validation rejects it
+unsigned long ConfigModule::secondsToMillis(long seconds) const {
+    // Checked before multiplying, a large value would otherwise wrap into the valid range
+    if (seconds <= 0 || (unsigned long)seconds > MAX_INTERVAL / 1000L) {
+        return 0;
+    }
+    return (unsigned long)seconds * 1000L;
+}
+
+// Function for validating configuration values
+bool ConfigModule::validate(const DeviceConfig& config) const {
+    if (config.sensorInterval < MIN_INTERVAL || config.sensorInterval > MAX_INTERVAL) {
+        return false;
+    }
+    if (config.minSensorInterval < MIN_INTERVAL || config.maxSensorInterval > MAX_INTERVAL
+        || config.minSensorInterval > config.maxSensorInterval) {
+        return false;
+    }
+#ifdef ADAPTIVE_SAMPLING
+    if (config.sensorInterval < config.minSensorInterval || config.sensorInterval > config.maxSensorInterval) {
+        return false; // Starting interval must be within adaptive bounds, without adaptive sampling they are unused
+    }
+#endif
+    if (config.soilMoistureInterval < MIN_INTERVAL || config.soilMoistureInterval > MAX_INTERVAL) {
+        return false;
+    }
+    if (config.wateringSequence == 0 || config.wateringSequence > MAX_WATERING_SEQUENCE) {
+        return false;
+    }
+    if (config.minimumWaterTankLevel < MIN_WATER_TANK_LEVEL || config.minimumWaterTankLevel > MAX_WATER_TANK_LEVEL) {
+        return false;
+    }
+    for (int i = 0; i < plantCount; i++) {
+        const PlantThresholds& plant = config.plants[i];
+        if (plant.soilWetValue < 0 || plant.soilDryValue > 1023 || plant.soilWetValue >= plant.soilDryValue) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Function for reading cached configuration from flash
+bool ConfigModule::loadFromFlash(DeviceConfig& config) {
+    File file = LittleFS.open(CACHE_FILE_PATH, "r");
+    if (!file) {
+        return false;
+    }
+
+    ConfigCacheHeader header;
+    bool valid = file.read((uint8_t*)&header, sizeof(header)) == sizeof(header)
+        && header.magic == CACHE_MAGIC
+        && header.size == sizeof(DeviceConfig)
+        && file.read((uint8_t*)&config, sizeof(config)) == sizeof(config)
+        && header.checksum == checksum((const uint8_t*)&config, sizeof(config));
+    file.close();
+    return valid;
+}
+
+// Function for writing configuration to flash
+bool ConfigModule::saveToFlash(const DeviceConfig& config) {
+    File file = LittleFS.open(CACHE_FILE_PATH, "w");
+    if (!file) {
+        LOG_ERROR("Failed to write configuration cache");
+        return false;
+    }
+
+    ConfigCacheHeader header = {CACHE_MAGIC, sizeof(DeviceConfig), checksum((const uint8_t*)&config, sizeof(config))};
+    bool written = file.write((const uint8_t*)&header, sizeof(header)) == sizeof(header)
+        && file.write((const uint8_t*)&config, sizeof(config)) == sizeof(config);
+    file.close();
+    return written;
+}
+
+// Function for calculating FNV-1a checksum
+uint32_t ConfigModule::checksum(const uint8_t* data, size_t length) {
+    uint32_t hash = 2166136261UL;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= data[i];
+        hash *= 16777619UL;
+    }
+    return hash;
+}
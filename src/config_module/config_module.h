@@ -0,0 +1,81 @@
+/**
+ * File: config_module.h
+ * Author: Joonas Nislin
+ * Date: 19.10.2026
+ * Description: This file contains header file of ConfigModule.
+ * Holds function declarations and constants for remote device configuration.
+ */
+
+#ifndef CONFIG_MODULE_H
+#define CONFIG_MODULE_H
+
+#include <ESP8266WiFi.h>
+#include "../mux_module/mux_module.h"
+
+#define CONFIG_MAX_PLANTS MUX_MAX_CHANNELS // One plant per multiplexer channel at most
+
+// Structure to represent soil moisture thresholds of one plant
+struct PlantThresholds {
+    int soilWetValue;
+    int soilDryValue;
+};
+
+// Structure to represent remotely tunable device configuration
+struct DeviceConfig {
+    uint32_t version; // Value of config/<deviceId>/version this configuration was read from
+    unsigned long sensorInterval; // Milliseconds between sensor readings, starting interval of adaptive sampling
+    unsigned long minSensorInterval; // Shortest interval adaptive sampling may use
+    unsigned long maxSensorInterval; // Longest interval adaptive sampling may use
+    unsigned long soilMoistureInterval; // Milliseconds between soil moisture readings
+    unsigned long wateringSequence; // Milliseconds the water pump runs
+    float minimumWaterTankLevel; // Largest allowed distance to water surface in cm
+    PlantThresholds plants[CONFIG_MAX_PLANTS];
+};
+
+class ConfigModule {
+public:
+    // Set compiled-in defaults and replace them with cached configuration from flash if valid
+    void begin(const DeviceConfig& defaults, int plantCount);
+
+    // Check remote version and fetch configuration only if it changed, returns true if configuration changed
+    bool sync(const String& deviceId);
+
+    // Currently active configuration
+    const DeviceConfig& get() const;
+
+    // Override sensor interval locally until next remote configuration change, returns false if out of bounds
+    bool setSensorInterval(unsigned long sensorInterval);
+
+    // Convert seconds to milliseconds, returns 0 if out of bounds so validation rejects it
+    unsigned long secondsToMillis(long seconds) const;
+
+private:
+    DeviceConfig current;
+    int plantCount = 0;
+
+    // Read configuration node into config, returns false if node is missing or invalid
+    bool fetchRemoteConfig(const String& deviceId, DeviceConfig& config);
+
+    // Check that configuration values are within allowed bounds
+    bool validate(const DeviceConfig& config) const;
+
+    // Read cached configuration from flash
+    bool loadFromFlash(DeviceConfig& config);
+
+    // Write configuration to flash
+    bool saveToFlash(const DeviceConfig& config);
+
+    // Checksum used to detect corrupted cache
+    static uint32_t checksum(const uint8_t* data, size_t length);
+
+    // Constants and Configuration Settings
+    const char* CACHE_FILE_PATH = "/config.bin";
+    const uint32_t CACHE_MAGIC = 0x56534346; // "VSCF"
+    const unsigned long MIN_INTERVAL = 60L * 1000L; // 1 minute
+    const unsigned long MAX_INTERVAL = 7L * 24L * 60L * 60L * 1000L; // 7 days
+    const unsigned long MAX_WATERING_SEQUENCE = 60L * 1000L; // 1 minute
+    const float MIN_WATER_TANK_LEVEL = 2.0; // HC-SR04 minimum distance in cm
+    const float MAX_WATER_TANK_LEVEL = 450.0; // HC-SR04 maximum distance in cm
+};
+
+#endif
@@ -0,0 +1,80 @@
+/**
+ * File: cost_module.cpp
+ * Author: Joonas Nislin
+ * Date: 19.10.2026
+ * Description: This file contains implementation of CostModule.
+ * Provides functionality for accounting the cost of sensor cycle, soil moisture cycle and event drain:
+ * - Upload attempts and bytes from the selected transport
+ * - AES blocks from aes_module and allocations from the cycle arena (heap allocations are not counted)
+ * - Peak heap use from the heap low-water mark, which is reset at stage start
+ * Every run is logged as "COST {json}" through the logger, tools/cost_check.py compares captured lines with a baseline.
+ */
+
+#include <umm_malloc/umm_malloc.h>
+#include "cost_module.h"
+#include "../aes_module/aes_module.h"
+#include "../arena_module/arena_module.h"
+#include "../transport_module/transport_module.h"
+#include "../log_module/log_module.h"
+
+#define LOG_TAG "cost"
+
+CostModule costModule;
+
+const char* const COST_STAGE_NAMES[NUM_COST_STAGES] = {"sensor_cycle", "soil_cycle", "event_drain"};
+
+// Function for taking counters at stage start
+void CostModule::begin(CostStage stage) {
+    snapshot(start[stage]);
+    umm_free_heap_size_min_reset(); // Low-water mark of this stage only
+    start[stage].peakHeap = ESP.getFreeHeap();
+}
+
+// Function for computing and printing cost since begin
+void CostModule::end(CostStage stage) {
+    CostSample now;
+    snapshot(now);
+
+    CostSample& sample = last[stage];
+    sample.requests = now.requests - start[stage].requests;
+    sample.bytes = now.bytes - start[stage].bytes;
+    sample.aesBlocks = now.aesBlocks - start[stage].aesBlocks;
+    sample.arenaAllocations = now.arenaAllocations - start[stage].arenaAllocations;
+    size_t lowestFree = umm_free_heap_size_min();
+    sample.peakHeap = start[stage].peakHeap > lowestFree ? start[stage].peakHeap - lowestFree : 0;
+    sample.micros = now.micros - start[stage].micros;
+    print(stage, sample);
+}
+
+// Function for getting cost of latest run of stage
+const CostSample& CostModule::getLast(CostStage stage) const {
+    return last[stage];
+}
+
+// Function for taking current value of every counter
+void CostModule::snapshot(CostSample& sample) const {
+    const TransportStats& stats = transport.getStats();
+    sample.requests = stats.messages + stats.failures;
+    sample.bytes = stats.bytes;
+    sample.aesBlocks = getEncryptedBlockCount();
+    sample.arenaAllocations = cycleArena.getAllocationCount();
+    sample.peakHeap = 0;
+    sample.micros = micros();
+}
+
+// Function for logging sample as one line
+void CostModule::print(CostStage stage, const CostSample& sample) const {
+    LOG_INFO("COST {\"stage\":\"%s\",\"requests\":%lu,\"bytes\":%lu,\"aes_blocks\":%lu,\"arena_allocs\":%lu,\"peak_heap\":%u,\"micros\":%lu}",
+             COST_STAGE_NAMES[stage], sample.requests, sample.bytes, sample.aesBlocks, sample.arenaAllocations,
+             (unsigned int)sample.peakHeap, sample.micros);
+}
+
+// Constructor, begins stage
+CostScope::CostScope(CostStage stage) : stage(stage) {
+    costModule.begin(stage);
+}
+
+// Destructor, ends stage
+CostScope::~CostScope() {
+    costModule.end(stage);
+}
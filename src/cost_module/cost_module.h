@@ -0,0 +1,66 @@
+/**
+ * File: cost_module.h
+ * Author: Joonas Nislin
+ * Date: 19.10.2026
+ * Description: This file contains header file of CostModule.
+ * Holds declarations for measuring network, encryption, memory and time cost of each loop stage.
+ */
+
+#ifndef COST_MODULE_H
+#define COST_MODULE_H
+
+#include <ESP8266WiFi.h>
+
+// Measured stages
+enum CostStage {
+    COST_SENSOR_CYCLE, // handleSensorReadings
+    COST_SOIL_CYCLE, // handleSoilMoistureReading
+    COST_EVENT_DRAIN, // One event sent by EventModule::loop
+    NUM_COST_STAGES
+};
+
+// Structure to represent cost of one stage run
+struct CostSample {
+    unsigned long requests; // Upload attempts, retries included
+    unsigned long bytes; // Upload bytes accepted by transport
+    unsigned long aesBlocks; // AES blocks encrypted
+    unsigned long arenaAllocations; // Cycle arena allocations, heap allocations show in peakHeap only
+    size_t peakHeap; // Most heap in use above stage start
+    unsigned long micros; // Duration, waits for network included
+};
+
+class CostModule {
+public:
+    // Take counters at stage start
+    void begin(CostStage stage);
+
+    // Compute cost since begin and log it as one machine-readable line
+    void end(CostStage stage);
+
+    // Get cost of latest run of stage
+    const CostSample& getLast(CostStage stage) const;
+
+private:
+    CostSample start[NUM_COST_STAGES]; // Counters at stage start, peakHeap holds free heap
+    CostSample last[NUM_COST_STAGES];
+
+    // Take current value of every counter
+    void snapshot(CostSample& sample) const;
+
+    // Log sample as "COST {json}" line
+    void print(CostStage stage, const CostSample& sample) const;
+};
+
+// Measure cost of stage from construction to end of scope
+class CostScope {
+public:
+    explicit CostScope(CostStage stage);
+    ~CostScope();
+
+private:
+    CostStage stage;
+};
+
+extern CostModule costModule;
+
+#endif
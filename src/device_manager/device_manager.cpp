@@ -7,179 +7,393 @@
  * - Modules initialization
  * - Device registration
  * - Sensor readings
- * - Water pump control
+ * - Water pump control (one pump per plant)
  */
 
 #include "device_manager.h"
 #include "../globals/globals.h"
 #include "../sensor_manager/sensor_manager.h"
+#include "../config_module/config_module.h"
+#include "../ota_module/ota_module.h"
+#include "../boot_module/boot_module.h"
+#include "../watchdog_module/watchdog_module.h"
+#include "../power_module/power_module.h"
+#include "../local_server/local_server.h"
+#include "../transport_module/transport_module.h"
+#include "../circuit_breaker/circuit_breaker.h"
+#include "../gateway_module/gateway_module.h"
+#include "../cipher_cache/cipher_cache.h"
+#include "../flash_strings/flash_strings.h"
+#include "../log_module/log_module.h"
+#include "../cost_module/cost_module.h"
+#include "../sampling_module/sampling_module.h"
+
+#define LOG_TAG "device"
 
 // Instances for managing API calls and events
 EventModule eventModule;
 SensorManager sensorManager;
 ApiManager apiManager;
+ConfigModule configModule;
+CommandModule commandModule;
+OtaModule otaModule;
+BootModule bootModule;
 
 // Device and network configuration
 String deviceId = "";
 String networkName = "";
 
 // Operation time tracking variables
-unsigned long previousSensorMillis = 0;
 unsigned long previousSoilMoistureMillis = 0;
-unsigned long waterPumpActivatedMillis = 0;
+unsigned long previousOtaCheckMillis = 0;
+unsigned long previousAuthorizationMillis = 0;
+unsigned long previousStatsMillis = 0;
 
 // Flags and initial sensor values
-bool waterPumpActivated = false;
 bool sensorReadingsDone = false;
-bool startWateringSequence = false;
-int currentSoilMoisture = 625;
-float currentWaterTankLevel = -1.0;
+bool firstUploadDone = false; // First sensor cycle runs right after boot
+bool deviceAuthorized = false; // Cached on flash, refreshed in the background
+bool authorizationChecked = false; // Live authorization check done since boot
+bool deviceRegistered = false; // Registration sent since boot
+FixedPoint currentWaterTankLevel = FixedPoint::invalid();
+
+// Plants watered by this device, add one entry per soil moisture probe and water pump relay
+// Soil probe: multiplexer channel, settle time (ms), calibration raw min and max
+// Wet and dry values are defaults, they can be overridden with remote configuration
+Plant plants[] = {
+    {{4, 10, 0, 1023}, 16, 500, 750, 625, false, false, 0},
+};
+const int NUM_PLANTS = sizeof(plants) / sizeof(plants[0]);
 
 // Setup function
 void DeviceManager::setup() {
     Serial.begin(SERIAL_BAUD_RATE); // Initialize serial communication at the specified baud rate
+    watchdog.begin(); // Keep breadcrumbs of previous boot before new ones are written
+    WatchdogScope watchdogScope(STAGE_SETUP);
+
+    // Switch sensor peripherals off, set pin modes and set water pumps to LOW as in OFF
+    powerModule.setup();
+    for (int i = 0; i < NUM_PLANTS; i++) {
+        pinMode(plants[i].waterPumpPin, OUTPUT);
+        digitalWrite(plants[i].waterPumpPin, LOW);
+    }
 
-    // Set pin modes and set water pump to LOW as in OFF
-    pinMode(DIGITAL_CD74HC4051E_CONTROL_PIN_2, OUTPUT);
-    pinMode(DIGITAL_CD74HC4051E_CONTROL_PIN_3, OUTPUT);
-    pinMode(DIGITAL_SOIL_MOISTURE_SENSOR_PIN, OUTPUT);
-    pinMode(DIGITAL_WATER_PUMP_PIN, OUTPUT);
-    digitalWrite(DIGITAL_WATER_PUMP_PIN, LOW);
-    digitalWrite(DIGITAL_SOIL_MOISTURE_SENSOR_PIN, LOW);
-
-    initModules(); // Initialize modules
+    initModules(); // Initialize modules, local setup overlaps WiFi association
 
     // Set device related variables
     deviceId = getDeviceId(); // Unique device identifier
     networkName = getNetworkName(); // WiFi SSID
+    cipherCache.update(networkName, getLocalIpAsString(), deviceId); // Static fields are encrypted once from these
+    transportModuleInit(deviceId); // Open upload session if transport keeps one
 
-    // Check and register device if not added to Firebase
-    if (!isDeviceAuthorized(deviceId)) {
-        registerDeviceForAuthorization(deviceId);
-    } else {
-        Serial.println("Device is authorized.");
-    }
+    // Use authorization state of previous boot, live check and registration run from loop
+    deviceAuthorized = bootModule.loadAuthorization();
+    LOG_INFO("%s", deviceAuthorized ? "Device is authorized (cached)." : "Device authorization pending.");
+
+    // Listen for commands from app
+    commandModule.begin(deviceId);
+    bootModule.markPhase(BOOT_CLOUD_READY);
+
+    // Serve latest readings to clients on local network
+    localServer.begin(deviceId);
+
+#ifdef GATEWAY_MODE
+    // Receive readings of sensor nodes, they are uploaded from loop
+    gateway.begin(espNowLink);
+#endif
 }
 
 // Function for initializing modules
 void DeviceManager::initModules() {
-    wifiModuleInit();
-    timeModuleInit();
+    // Start WiFi association first, it takes seconds and needs no CPU from us
+    wifiModuleBegin();
+    bootModule.markPhase(BOOT_WIFI_STARTED);
+
+    // Local initialization runs while the radio associates
+    sensorManager.setup();
     aesModuleInit();
+    initConfig(); // Load cached configuration, no network round trip needed
+    bootModule.markPhase(BOOT_LOCAL_INIT_DONE);
+
+    // Network dependent modules
+    wifiModuleWaitConnected();
+    bootModule.markPhase(BOOT_WIFI_CONNECTED);
+    timeModuleInit();
     firebaseModuleInit();
-    sensorManager.setup();
+}
+
+// Function for loading configuration with compiled-in values as defaults
+void DeviceManager::initConfig() {
+    DeviceConfig defaults = {};
+    defaults.sensorInterval = DEFAULT_SENSOR_INTERVAL;
+    defaults.minSensorInterval = DEFAULT_MIN_SENSOR_INTERVAL;
+    defaults.maxSensorInterval = DEFAULT_MAX_SENSOR_INTERVAL;
+    defaults.soilMoistureInterval = DEFAULT_SOIL_MOISTURE_INTERVAL;
+    defaults.wateringSequence = DEFAULT_WATERING_SEQUENCE;
+    defaults.minimumWaterTankLevel = DEFAULT_MINIMUM_WATER_TANK_LEVEL;
+    for (int i = 0; i < NUM_PLANTS && i < CONFIG_MAX_PLANTS; i++) {
+        defaults.plants[i].soilWetValue = plants[i].soilWetValue;
+        defaults.plants[i].soilDryValue = plants[i].soilDryValue;
+    }
+
+    configModule.begin(defaults, NUM_PLANTS);
+    applyConfig();
+}
+
+// Function for applying active configuration to plants
+void DeviceManager::applyConfig() {
+    const DeviceConfig& config = configModule.get();
+    for (int i = 0; i < NUM_PLANTS && i < CONFIG_MAX_PLANTS; i++) {
+        plants[i].soilWetValue = config.plants[i].soilWetValue;
+        plants[i].soilDryValue = config.plants[i].soilDryValue;
+    }
+#ifdef ADAPTIVE_SAMPLING
+    sampler.setBounds(config.minSensorInterval, config.sensorInterval, config.maxSensorInterval);
+#else
+    sampler.setBounds(config.sensorInterval, config.sensorInterval, config.sensorInterval); // Fixed interval
+#endif
 }
 
 // Function for registering device
-void DeviceManager::registerDeviceForAuthorization(String deviceId) {
+void DeviceManager::registerDeviceForAuthorization(const String& deviceId) {
     String localIp = getLocalIpAsString();
 
     // Register device and send registration data
     if (apiManager.encryptAndSendDeviceRegistration(deviceId, networkName)) {
-        Serial.println("Device registered.");
+        LOG_INFO("Device registered.");
 
         // Send device info data
         if (apiManager.encryptAndSendDeviceInfo(deviceId, networkName, localIp)) {
-            Serial.println("Device info sent.");
+            LOG_INFO("Device info sent.");
         } else {
-            Serial.println("Failed to send device info.");
+            LOG_ERROR("Failed to send device info.");
             handleEvent(ERROR, ADD_DEVICE_INFO_ERROR_MESSAGE, DEVICE_INFO);
         }
     } else {
-        Serial.println("Failed to register device.");
+        LOG_ERROR("Failed to register device.");
         handleEvent(ERROR, ADD_AUTHORIZED_DEVICE_ERROR_MESSAGE, REGISTRATION);
     }
 }
 
+// Function for checking authorization and registering device if needed, cached state is updated
+void DeviceManager::handleAuthorizationCheck(unsigned long currentMillis) {
+    WatchdogScope watchdogScope(STAGE_AUTHORIZATION);
+    authorizationChecked = true;
+    previousAuthorizationMillis = currentMillis;
+
+    AuthorizationStatus status = isDeviceAuthorized(deviceId);
+    if (status == AUTHORIZATION_UNKNOWN) {
+        // Network error or TLS out of memory, registering now would de-authorize an authorized device
+        LOG_WARNING("Authorization check failed, keeping cached state.");
+        return;
+    }
+
+    bool authorized = status == AUTHORIZATION_GRANTED;
+    if (status == AUTHORIZATION_NOT_REGISTERED && !deviceRegistered) {
+        registerDeviceForAuthorization(deviceId); // Register once per boot, only if node does not exist
+        deviceRegistered = true;
+    } else if (authorized && !deviceAuthorized) {
+        LOG_INFO("Device is authorized.");
+    }
+
+    deviceAuthorized = authorized;
+    bootModule.saveAuthorization(authorized);
+}
+
 // Function for checking soil moisture status and decision for starting watering sequence
-bool DeviceManager::checkSoilStatus(int soilMoisture) {
+bool DeviceManager::checkSoilStatus(const Plant& plant) {
     bool startWateringSequenceReturnValue = false; // Return variable, defaults to false
-
-    // If statement for checking soil status
-    if (soilMoisture < SOIL_WET_VALUE) {
-        Serial.println(SEND_SOIL_MOISTURE_STATUS_WET_MESSAGE);
-        handleEvent(INFO, SEND_SOIL_MOISTURE_STATUS_WET_MESSAGE, SOIL_MOISTURE_INFO);
-    } else if (soilMoisture >= SOIL_WET_VALUE && soilMoisture < SOIL_DRY_VALUE) {
-        Serial.println(SEND_SOIL_MOISTURE_STATUS_OPTIMAL_MESSAGE);
-        handleEvent(INFO, SEND_SOIL_MOISTURE_STATUS_OPTIMAL_MESSAGE, SOIL_MOISTURE_INFO);
+    int soilMoisture = plant.currentSoilMoisture;
+    PGM_P statusMessage; // Status message in flash
+
+    // If statement for checking soil status against plant specific thresholds
+    if (soilMoisture < 0) {
+        return false; // Probe could not be read, never water based on it
+    } else if (soilMoisture < plant.soilWetValue) {
+        statusMessage = SEND_SOIL_MOISTURE_STATUS_WET_MESSAGE;
+    } else if (soilMoisture >= plant.soilWetValue && soilMoisture < plant.soilDryValue) {
+        statusMessage = SEND_SOIL_MOISTURE_STATUS_OPTIMAL_MESSAGE;
     } else {
-        Serial.println(SEND_SOIL_MOISTURE_STATUS_DRY_MESSAGE);
-        handleEvent(INFO, SEND_SOIL_MOISTURE_STATUS_DRY_MESSAGE, SOIL_MOISTURE_INFO);
+        statusMessage = SEND_SOIL_MOISTURE_STATUS_DRY_MESSAGE;
         startWateringSequenceReturnValue = true; // If soil is dry, start watering sequence
     }
 
+    char message[48]; // Create array to store status message copied from flash
+    copyFlashString(message, sizeof(message), statusMessage);
+    LOG_INFO("%s", message);
+    handleEvent(INFO, statusMessage, SOIL_MOISTURE_INFO);
+
     // Return result
     return startWateringSequenceReturnValue;
 }
 
-// Function for activating water pump relay
-void DeviceManager::activateWaterPump(bool activate) {
-    digitalWrite(DIGITAL_WATER_PUMP_PIN, activate ? HIGH : LOW);
+// Function for activating water pump relay of plant
+void DeviceManager::activateWaterPump(const Plant& plant, bool activate) {
+    digitalWrite(plant.waterPumpPin, activate ? HIGH : LOW);
 }
 
 // Function for activating soil moisture sensor relay
 void DeviceManager::activateSoilMoistureSensor(bool activate) {
-    digitalWrite(DIGITAL_SOIL_MOISTURE_SENSOR_PIN, activate ? HIGH : LOW);
     if (activate) {
-        delay(1000);
+        powerModule.ensureOn(PERIPHERAL_SOIL_PROBES); // Waits for probe warm-up
     } else {
+        powerModule.powerOff(PERIPHERAL_SOIL_PROBES);
         delay(100);
     }
 }
 
 // Function for sending latest watering time to firebase
-void DeviceManager::sendLatestWateringTime(String deviceId, String networkName) {
-    if (apiManager.encryptAndSendLatestWateringTime(getCurrentTimeAsString(), deviceId, networkName)) {
-        Serial.println("Watering time sent successfully.");
+void DeviceManager::sendLatestWateringTime(const String& deviceId, const String& networkName) {
+    char currentTime[EPOCH_STRING_LENGTH]; // Create array to store current time
+    getCurrentTimeAsString(currentTime, sizeof(currentTime));
+    if (apiManager.encryptAndSendLatestWateringTime(currentTime, deviceId, networkName)) {
+        LOG_DEBUG("Watering time sent successfully.");
     } else {
-        Serial.println("Failed to send watering time.");
+        LOG_ERROR("Failed to send watering time.");
         handleEvent(ERROR, SEND_LATEST_WATERING_TIME_ERROR_MESSAGE, LATEST_WATERING_TIME);
     }
 }
 
 // Function for sending latest sensor reading time to firebase
-void DeviceManager::sendLatestSensorReadingTime(String deviceId, String networkName) {
-    if (apiManager.encryptAndSendLatestSensorReadingTime(getCurrentTimeAsString(), deviceId, networkName)) {
-        Serial.println("Sensor reading time sent successfully.");
+void DeviceManager::sendLatestSensorReadingTime(const String& deviceId, const String& networkName) {
+    char currentTime[EPOCH_STRING_LENGTH]; // Create array to store current time
+    getCurrentTimeAsString(currentTime, sizeof(currentTime));
+    if (apiManager.encryptAndSendLatestSensorReadingTime(currentTime, deviceId, networkName)) {
+        LOG_DEBUG("Sensor reading time sent successfully.");
     } else {
-        Serial.println("Failed to send sensor reading time.");
+        LOG_ERROR("Failed to send sensor reading time.");
         handleEvent(ERROR, SEND_LATEST_SENSOR_READING_TIME_ERROR_MESSAGE, LATEST_SENSOR_READING_TIME);
     }
 }
 
 // Function for sending water tank refill notification to firebase
-void DeviceManager::sendWaterTankRefillNotification(String deviceId, String networkName) {
-    if (apiManager.encryptAndSendWaterTankRefillNotification(getCurrentTimeAsString(), deviceId, networkName)) {
-        Serial.println("Water tank refill notification sent successfully.");
+void DeviceManager::sendWaterTankRefillNotification(const String& deviceId, const String& networkName) {
+    char currentTime[EPOCH_STRING_LENGTH]; // Create array to store current time
+    getCurrentTimeAsString(currentTime, sizeof(currentTime));
+    if (apiManager.encryptAndSendWaterTankRefillNotification(currentTime, deviceId, networkName)) {
+        LOG_DEBUG("Water tank refill notification sent successfully.");
     } else {
-        Serial.println("Failed to send water tank refill notification.");
+        LOG_ERROR("Failed to send water tank refill notification.");
         handleEvent(ERROR, SEND_WATER_TANK_REFILL_NOTIFICATION_ERROR_MESSAGE, WATER_TANK_REFILL_NOTIFICATION);
     }
 }
 
 // Function that wraps all sensor read related logic
-void DeviceManager::handleSensorReadings(unsigned long currentMillis) {
-    // Read and send sensor data
-    sensorManager.readAndSendTemperature(deviceId, networkName);
-    sensorManager.readAndSendHumidity(deviceId, networkName);
-    sensorManager.readAndSendAirPressure(deviceId, networkName);
-    sensorManager.readAndSendLuminosity(deviceId, networkName);
-    currentWaterTankLevel = sensorManager.readAndSendWaterTankLevel(deviceId, networkName);
+void DeviceManager::handleSensorReadings(unsigned long currentMillis, bool readAll) {
+    WatchdogScope watchdogScope(STAGE_SENSOR_CYCLE);
+    // Pick up configuration changes, only the version number is transferred if nothing changed
+    if (configModule.sync(deviceId)) {
+        applyConfig();
+    }
+
+    // Cost covers reads and uploads of the cycle, config and authorization reads are not uploads
+    costModule.begin(COST_SENSOR_CYCLE);
+
+    // Reconnect may have changed access point or address, their cached ciphertext is dropped then
+    if (WiFi.status() == WL_CONNECTED) {
+        networkName = getNetworkName();
+        cipherCache.update(networkName, getLocalIpAsString(), deviceId);
+    }
+
+    // Metrics due now or soon enough to share this cycle
+    bool due[NUM_SAMPLED_METRICS];
+    for (int i = 0; i < NUM_SAMPLED_METRICS; i++) {
+        due[i] = readAll || sampler.shouldSample((SampledMetric)i, currentMillis);
+    }
+
+    // Switch on peripherals read later in the cycle, their warm-up overlaps the uploads before them
+    if (due[SAMPLE_LUMINOSITY]) {
+        powerModule.powerOn(PERIPHERAL_PHOTORESISTOR);
+    }
+    if (due[SAMPLE_WATER_TANK_LEVEL]) {
+        powerModule.powerOn(PERIPHERAL_ULTRASONIC);
+    }
+
+    // Read and send sensor data, environment sensor reads all of its values in one transaction
+    if (due[SAMPLE_TEMPERATURE] || due[SAMPLE_HUMIDITY] || due[SAMPLE_AIR_PRESSURE]) {
+        sensorManager.readEnvironment();
+    }
+    if (due[SAMPLE_TEMPERATURE]) {
+        sampler.recordSample(SAMPLE_TEMPERATURE, sensorManager.readAndSendTemperature(deviceId, networkName), currentMillis);
+    }
+    if (due[SAMPLE_HUMIDITY]) {
+        sampler.recordSample(SAMPLE_HUMIDITY, sensorManager.readAndSendHumidity(deviceId, networkName), currentMillis);
+    }
+    if (due[SAMPLE_AIR_PRESSURE]) {
+        sampler.recordSample(SAMPLE_AIR_PRESSURE, sensorManager.readAndSendAirPressure(deviceId, networkName), currentMillis);
+    }
+    if (due[SAMPLE_LUMINOSITY]) {
+        sampler.recordSample(SAMPLE_LUMINOSITY, sensorManager.readAndSendLuminosity(deviceId, networkName), currentMillis);
+    }
+    if (due[SAMPLE_WATER_TANK_LEVEL]) {
+        currentWaterTankLevel = sensorManager.readAndSendWaterTankLevel(deviceId, networkName);
+        sampler.recordSample(SAMPLE_WATER_TANK_LEVEL, currentWaterTankLevel, currentMillis);
+    }
+    sensorManager.reportFaults(); // One event for all readings not uploaded in this cycle
 
     sendLatestSensorReadingTime(deviceId, networkName);
-    // Reset the timer
-    previousSensorMillis = currentMillis; 
+    printStats(currentMillis);
+
+    // Release upload buffers of the cycle and report arena and heap state
+    cycleArena.reset();
+    LOG_INFO("Cycle arena high-water mark: %u / %u bytes, failed allocations: %lu, largest free heap block: %u",
+             (unsigned int)cycleArena.getHighWaterMark(), (unsigned int)cycleArena.getCapacity(),
+             (unsigned long)cycleArena.getFailedAllocations(), (unsigned int)ESP.getMaxFreeBlockSize());
+    if (!firstUploadDone) {
+        bootModule.markPhase(BOOT_FIRST_UPLOAD);
+        bootModule.printReport();
+        firstUploadDone = true;
+    }
+
+    costModule.end(COST_SENSOR_CYCLE);
+
+    // Confirm authorization after the upload, so readings are never delayed by it
+    handleAuthorizationCheck(currentMillis);
+}
+
+// Function for logging diagnostics of all modules at a slower period than sensor cycles
+void DeviceManager::printStats(unsigned long currentMillis) {
+    // First cycle is reported, then one report per interval, each report fits in the log ring buffer
+    if (firstUploadDone && currentMillis - previousStatsMillis < STATS_REPORT_INTERVAL) {
+        return;
+    }
+    previousStatsMillis = currentMillis;
+
+    printFirebaseWriteStats(); // Report backend write load caused by this device
+    powerModule.printReport(); // Report sensor on-time and estimated charge per day
+    localServer.printStats(); // Report local requests and their cost on loop time
+    transport.printStats(); // Report upload bytes per message of selected transport
+    uploadBreaker.printStats(); // Report upload breaker state
+    cipherCache.printStats(); // Report encryptions since previous report and ciphertext reused from cache
+    logger.printStats(); // Report log lines dropped because UART could not keep up
+    sampler.printStats(); // Report interval and samples per day of each metric against fixed interval
+#ifdef GATEWAY_MODE
+    gateway.printStats(); // Report received, duplicate and uploaded node readings
+#endif
 }
 
 // Function that handles soil moisture reading related logic
 void DeviceManager::handleSoilMoistureReading(unsigned long currentMillis, bool checkWatering) {
-    // Activate soil moisture sensor via relay
+    WatchdogScope watchdogScope(STAGE_SOIL_MOISTURE);
+    CostScope costScope(COST_SOIL_CYCLE);
+    MuxChannel soilChannels[NUM_PLANTS];
+    int soilMoistures[NUM_PLANTS];
+    for (int i = 0; i < NUM_PLANTS; i++) {
+        soilChannels[i] = plants[i].soilChannel;
+    }
+
+    // Activate soil moisture sensors via relay
     activateSoilMoistureSensor(true);
     delay(1000);
-    currentSoilMoisture = sensorManager.readAndSendSoilMoisture(deviceId, networkName);
+    sensorManager.readAndSendSoilMoisture(soilChannels, NUM_PLANTS, soilMoistures, deviceId, networkName);
     delay(100);
     // Deactivate soil moisture sensor via relay
     activateSoilMoistureSensor(false);
+    sensorManager.reportFaults();
+
+    for (int i = 0; i < NUM_PLANTS; i++) {
+        plants[i].currentSoilMoisture = soilMoistures[i];
+    }
 
     if (checkWatering) {
         checkIfWateringIsNeeded(currentMillis);
@@ -187,66 +401,180 @@ void DeviceManager::handleSoilMoistureReading(unsigned long currentMillis, bool
 }
 
 void DeviceManager::checkIfWateringIsNeeded(unsigned long currentMillis) {
-    startWateringSequence = checkSoilStatus(currentSoilMoisture);
-    Serial.println("Start watering sequence:");
-    Serial.println(startWateringSequence == 1 ? "true" : "false");
+    for (int i = 0; i < NUM_PLANTS; i++) {
+        plants[i].startWateringSequence = checkSoilStatus(plants[i]);
+        LOG_INFO("Start watering sequence for plant %d: %s", i, plants[i].startWateringSequence ? "true" : "false");
+    }
     sensorReadingsDone = true;
     // Reset the timer for the next soil moisture reading
     previousSoilMoistureMillis = currentMillis;
 }
 
+// Function for checking if any plant is waiting for watering sequence
+bool DeviceManager::isWateringSequencePending() {
+    for (int i = 0; i < NUM_PLANTS; i++) {
+        if (plants[i].startWateringSequence) {
+            return true;
+        }
+    }
+    return false;
+}
+
 void DeviceManager::handleWateringSequence(unsigned long currentMillis) {
+    WatchdogScope watchdogScope(STAGE_WATERING);
     sensorReadingsDone = false;
-    startWateringSequence = false;
+    // Unknown water tank level never allows watering, sequence is tried again after next readings
+    if (!currentWaterTankLevel.isValid()) {
+        for (int i = 0; i < NUM_PLANTS; i++) {
+            plants[i].startWateringSequence = false;
+        }
+        LOG_WARNING("Water tank level unknown, watering skipped.");
+        return;
+    }
     // Check if current water tank level is below minimum allowed level
-    if (currentWaterTankLevel <= MINIMUM_WATER_TANK_LEVEL) {
-        Serial.println("Activating water pump.");
-        // Activate water pump via relay
-        activateWaterPump(true);
-        waterPumpActivatedMillis = currentMillis;
-        waterPumpActivated = true;
+    if (currentWaterTankLevel <= FixedPoint::fromFloat(configModule.get().minimumWaterTankLevel)) {
+        for (int i = 0; i < NUM_PLANTS; i++) {
+            if (!plants[i].startWateringSequence) {
+                continue;
+            }
+            LOG_INFO("Activating water pump of plant %d", i);
+            // Activate water pump via relay
+            activateWaterPump(plants[i], true);
+            sampler.notifyEvent(SAMPLE_WATER_TANK_LEVEL); // Follow the level drop closely
+            plants[i].waterPumpActivatedMillis = currentMillis;
+            plants[i].waterPumpActivated = true;
+            plants[i].startWateringSequence = false;
+        }
     } else {
+        for (int i = 0; i < NUM_PLANTS; i++) {
+            plants[i].startWateringSequence = false;
+        }
         // Send notification if water tank level is too low
-        Serial.println("Water tank level is too low, please refill.");
+        LOG_WARNING("Water tank level is too low, please refill.");
         sendWaterTankRefillNotification(deviceId, networkName);
     }
 }
 
-void DeviceManager::handleWaterPumpDeactivation(unsigned long currentMillis) {
-    Serial.println("Stop water pump!");
-    waterPumpActivated = false;
+void DeviceManager::handleWaterPumpDeactivation(Plant& plant, unsigned long currentMillis) {
+    LOG_INFO("Stop water pump!");
+    plant.waterPumpActivated = false;
     // Deactivate water pump via relay
-    activateWaterPump(false);
+    activateWaterPump(plant, false);
     sendLatestWateringTime(deviceId, networkName);
     // Read soil moisture after watering to get the latest readings in app
     handleSoilMoistureReading(currentMillis, false);
 }
 
+// Function for checking firmware manifest, only called while no water pump is running
+void DeviceManager::handleOtaCheck(unsigned long currentMillis) {
+    previousOtaCheckMillis = currentMillis;
+    if (otaModule.checkAndUpdate(deviceId)) {
+        LOG_INFO("Restarting into new firmware.");
+        restartDevice(); // Bootloader decompresses and copies staged image
+    }
+}
+
+// Function for executing command received from app
+void DeviceManager::handleCommand(const Command& command, unsigned long currentMillis) {
+    bool success = false;
+
+    // Data sending and watering stay disabled while authorization is pending
+    if (!deviceAuthorized && (equalsFlashString(command.type.c_str(), COMMAND_WATER_NOW)
+                              || equalsFlashString(command.type.c_str(), COMMAND_READ_NOW))) {
+        LOG_WARNING("Command %s rejected, device is not authorized.", command.type.c_str());
+        commandModule.acknowledge(command, COMMAND_UNAUTHORIZED);
+        return;
+    }
+
+    if (equalsFlashString(command.type.c_str(), COMMAND_WATER_NOW)) {
+        if (command.plant >= 0 && command.plant < NUM_PLANTS) {
+            // Run watering sequence for the plant right away, tank level is still checked
+            plants[command.plant].startWateringSequence = true;
+            handleWateringSequence(currentMillis);
+            success = plants[command.plant].waterPumpActivated;
+        }
+    } else if (equalsFlashString(command.type.c_str(), COMMAND_READ_NOW)) {
+        handleSensorReadings(currentMillis, true);
+        success = true;
+    } else if (equalsFlashString(command.type.c_str(), COMMAND_SET_INTERVAL)) {
+        success = configModule.setSensorInterval(configModule.secondsToMillis(command.value));
+        if (success) {
+            applyConfig();
+        }
+    } else if (equalsFlashString(command.type.c_str(), COMMAND_REBOOT)) {
+        // Acknowledge before restart, otherwise the command would be executed again after boot
+        commandModule.acknowledge(command, COMMAND_OK);
+        restartDevice();
+        return;
+    } else {
+        LOG_WARNING("Unknown command: %s", command.type.c_str());
+    }
+
+    commandModule.acknowledge(command, success ? COMMAND_OK : COMMAND_FAILED);
+}
+
 // Main loop function for DeviceManager
 void DeviceManager::loop() {
     unsigned long currentMillis = millis(); // Current time in milliseconds since device started
 
+    // Answer local clients first, they expect sub 100 ms responses
+    localServer.loop();
+    logger.loop(); // Send buffered log lines as far as UART has room
+    transport.loop(); // Keep upload session alive
+#ifdef GATEWAY_MODE
+    if (deviceAuthorized) {
+        gateway.loop(networkName); // Take node frames and upload batches
+    }
+#endif
+
+    // Execute commands from app as soon as they arrive
+    Command command;
+    watchdog.enter(STAGE_COMMAND_POLL);
+    bool commandReceived = commandModule.poll(command);
+    watchdog.exit(STAGE_COMMAND_POLL);
+    if (commandReceived) {
+        handleCommand(command, currentMillis);
+    }
+
+    // Check authorization in the background while it is not confirmed
+    if (!deviceAuthorized && (!authorizationChecked || currentMillis - previousAuthorizationMillis >= AUTHORIZATION_RETRY_INTERVAL)) {
+        handleAuthorizationCheck(currentMillis);
+    }
+
     // Check if sensor readings are done and soil status is dry
-    if (sensorReadingsDone && startWateringSequence) {
+    if (sensorReadingsDone && isWateringSequencePending()) {
         handleWateringSequence(currentMillis);
     } else {
-        // Check if its time to read sensors (every 30 seconds)
-        if ((currentMillis - previousSensorMillis >= SENSOR_INTERVAL) && isDeviceAuthorized(deviceId)) {       
-            handleSensorReadings(currentMillis);
+        // Check if any metric is due for sampling, first cycle runs right after boot
+        if ((!firstUploadDone || sampler.isAnyDue(currentMillis)) && deviceAuthorized) {
+            handleSensorReadings(currentMillis, false);
         } else {
-            // Process created events
+            // Report crash of previous boot and stalls, then process created events
+            watchdog.reportPending();
+            uploadBreaker.reportPending();
+            watchdog.enter(STAGE_EVENT_LOOP);
             eventModule.loop();
+            watchdog.exit(STAGE_EVENT_LOOP);
         }
 
         // Check if its time to read soil moisture (every 12 minutes)
-        if ((currentMillis - previousSoilMoistureMillis >= SOIL_MOISTURE_INTERVAL) && isDeviceAuthorized(deviceId)) {
+        if ((currentMillis - previousSoilMoistureMillis >= configModule.get().soilMoistureInterval) && deviceAuthorized) {
             // If the soil moisture interval has passed, read soil moisture
             handleSoilMoistureReading(currentMillis, true);
         }
     }
 
-    // Check if the water pump has been activated and stop it after the watering sequence
-    if (waterPumpActivated && (currentMillis - waterPumpActivatedMillis >= WATERING_SEQUENCE)) {
-        handleWaterPumpDeactivation(currentMillis);
+    // Check if a water pump has been activated and stop it after the watering sequence
+    bool waterPumpRunning = false;
+    for (int i = 0; i < NUM_PLANTS; i++) {
+        if (plants[i].waterPumpActivated && (currentMillis - plants[i].waterPumpActivatedMillis >= configModule.get().wateringSequence)) {
+            handleWaterPumpDeactivation(plants[i], currentMillis);
+        }
+        waterPumpRunning = waterPumpRunning || plants[i].waterPumpActivated;
+    }
+
+    // Check for firmware update once a day, never in the middle of a watering sequence
+    if (!waterPumpRunning && !isWateringSequencePending() && (currentMillis - previousOtaCheckMillis >= OTA_CHECK_INTERVAL) && deviceAuthorized) {
+        handleOtaCheck(currentMillis);
     }
 }
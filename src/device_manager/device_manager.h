@@ -14,6 +14,20 @@
 #define DEVICE_MANAGER_H
 
 #include <ESP8266WiFi.h>
+#include "../mux_module/mux_module.h"
+#include "../command_module/command_module.h"
+
+// Structure to represent one plant with its own soil moisture probe, thresholds and water pump
+struct Plant {
+    MuxChannel soilChannel; // Multiplexer channel, settle time and calibration of soil moisture probe
+    int waterPumpPin; // Relay pin of the water pump
+    int soilWetValue; // Readings below this are reported as wet
+    int soilDryValue; // Readings at or above this start watering sequence
+    int currentSoilMoisture; // Latest soil moisture reading
+    bool startWateringSequence; // Soil was dry on latest check
+    bool waterPumpActivated; // Water pump is running
+    unsigned long waterPumpActivatedMillis; // Time when water pump was activated
+};
 
 class DeviceManager {
 public:
@@ -26,29 +40,41 @@ private:
     // Initialize all modules used by the device
     void initModules();
 
+    // Load cached or default configuration
+    void initConfig();
+
+    // Apply active configuration to plants
+    void applyConfig();
+
+    // Check authorization on Firebase, register if not authorized and cache the result
+    void handleAuthorizationCheck(unsigned long currentMillis);
+
     // Register the device for authorization on Firebase
-    void registerDeviceForAuthorization(String deviceId);
+    void registerDeviceForAuthorization(const String& deviceId);
 
     // Send the latest watering time to Firebase
-    void sendLatestWateringTime(String deviceId, String networkName);
+    void sendLatestWateringTime(const String& deviceId, const String& networkName);
 
     // Send the latest sensor reading time to Firebase
-    void sendLatestSensorReadingTime(String deviceId, String networkName);
+    void sendLatestSensorReadingTime(const String& deviceId, const String& networkName);
 
     // Send a water tank refill notification to Firebase
-    void sendWaterTankRefillNotification(String deviceId, String networkName);
+    void sendWaterTankRefillNotification(const String& deviceId, const String& networkName);
 
-    // Check soil moisture status and return boolean to check if watering is needed
-    bool checkSoilStatus(int soilMoisture);
+    // Check soil moisture status of plant and return boolean to check if watering is needed
+    bool checkSoilStatus(const Plant& plant);
 
-    // Activate or deactivate the water pump
-    void activateWaterPump(bool activate);
+    // Activate or deactivate the water pump of plant
+    void activateWaterPump(const Plant& plant, bool activate);
 
     // Activate or deactivate soil moisture sensor
     void activateSoilMoistureSensor(bool activate);
 
-    // Wrapper function for all the rest sensor readings
-    void handleSensorReadings(unsigned long currentMillis);
+    // Wrapper function for all the rest sensor readings, only metrics due for sampling are read unless readAll is set
+    void handleSensorReadings(unsigned long currentMillis, bool readAll);
+
+    // Log diagnostics of all modules, at most once per STATS_REPORT_INTERVAL
+    void printStats(unsigned long currentMillis);
 
     // Wrapper function for handling soil moisture sensor reading
     void handleSoilMoistureReading(unsigned long currentMillis, bool checkWatering);
@@ -60,20 +86,29 @@ private:
     void handleWateringSequence(unsigned long currentMillis);
 
     // Wrapper function for handling water pump deactivation
-    void handleWaterPumpDeactivation(unsigned long currentMillis);
+    void handleWaterPumpDeactivation(Plant& plant, unsigned long currentMillis);
+
+    // Check if any plant is waiting for watering sequence
+    bool isWateringSequencePending();
+
+    // Check for newer firmware and restart into it once staged
+    void handleOtaCheck(unsigned long currentMillis);
+
+    // Execute command received from app and acknowledge it
+    void handleCommand(const Command& command, unsigned long currentMillis);
 
     // Constants and Configuration Settings
     const int SERIAL_BAUD_RATE = 115200;
-    const unsigned long SOIL_MOISTURE_INTERVAL = 24L * 60L * 60L * 1000L; // 24 hours
-    const unsigned long SENSOR_INTERVAL = 29L * 60L * 1000L; // 29 minutes
-    const int WATERING_SEQUENCE = 12000;
-    const int ANALOG_OUTPUT_PIN = A0;
-    const int DIGITAL_WATER_PUMP_PIN = 16;
-    const int DIGITAL_CD74HC4051E_CONTROL_PIN_2 = 12;
-    const int DIGITAL_CD74HC4051E_CONTROL_PIN_3 = 13;
-    const int DIGITAL_SOIL_MOISTURE_SENSOR_PIN = 14;
-    const int SOIL_WET_VALUE = 500;
-    const int SOIL_DRY_VALUE = 750;
+    // Defaults used until remote configuration is received
+    const unsigned long DEFAULT_SOIL_MOISTURE_INTERVAL = 24L * 60L * 60L * 1000L; // 24 hours
+    const unsigned long DEFAULT_SENSOR_INTERVAL = 29L * 60L * 1000L; // 29 minutes
+    const unsigned long DEFAULT_MIN_SENSOR_INTERVAL = 5L * 60L * 1000L; // 5 minutes
+    const unsigned long DEFAULT_MAX_SENSOR_INTERVAL = 2L * 60L * 60L * 1000L; // 2 hours
+    const unsigned long DEFAULT_WATERING_SEQUENCE = 12000;
+    const float DEFAULT_MINIMUM_WATER_TANK_LEVEL = 12.5;
+    const unsigned long AUTHORIZATION_RETRY_INTERVAL = 60L * 1000L; // 1 minute while not authorized
+    const unsigned long OTA_CHECK_INTERVAL = 24L * 60L * 60L * 1000L; // 24 hours
+    const unsigned long STATS_REPORT_INTERVAL = 60L * 60L * 1000L; // 1 hour between diagnostics reports
 };
 
 #endif
@@ -4,34 +4,139 @@
  * Date: 1.9.2023
  * Description: This file contains implementation of EventModule.
  * Provides functionality for creating and sending events to firebase.
- * Uses circular event buffer for enqueuing and dequeuing events.
+ * Events are queued in priority lanes by severity. ERROR events are sent first, and when the
+ * queue is full the oldest event of the lowest priority lane is evicted to make room.
+ * Repeated events with the same type and message are coalesced into one record with a count.
  */
 
 #include "event_module.h"
 #include "../globals/globals.h"
+#include "../path_builder/path_builder.h"
+#include "../transport_module/transport_module.h"
+#include "../circuit_breaker/circuit_breaker.h"
+#include "../cipher_cache/cipher_cache.h"
+#include "../log_module/log_module.h"
+#include "../cost_module/cost_module.h"
 
-// Function for enqueuing an event into the circular buffer
+#define LOG_TAG "event"
+
+// Event messages
+const char ADD_DEVICE_INFO_ERROR_MESSAGE[] PROGMEM = "Failed to add device information.";
+const char ADD_AUTHORIZED_DEVICE_PENDING_MESSAGE[] PROGMEM = "Device is pending authorization. Data sending disabled.";
+const char ADD_AUTHORIZED_DEVICE_ERROR_MESSAGE[] PROGMEM = "Failed to add device to authorized devices";
+const char SEND_TEMPERATURE_ERROR_MESSAGE[] PROGMEM = "Failed to send temperature data.";
+const char SEND_HUMIDITY_ERROR_MESSAGE[] PROGMEM = "Failed to send humidity data.";
+const char SEND_AIR_PRESSURE_ERROR_MESSAGE[] PROGMEM = "Failed to send air pressure data.";
+const char SEND_SOIL_MOISTURE_ERROR_MESSAGE[] PROGMEM = "Failed to send soil moisture data.";
+const char SEND_LUMINOSITY_ERROR_MESSAGE[] PROGMEM = "Failed to send luminosity data.";
+const char SEND_WATER_TANK_LEVEL_ERROR_MESSAGE[] PROGMEM = "Failed to send water tank level data.";
+const char SEND_LATEST_WATERING_TIME_ERROR_MESSAGE[] PROGMEM = "Failed to send latest watering time.";
+const char SEND_LATEST_SENSOR_READING_TIME_ERROR_MESSAGE[] PROGMEM = "Failed to send latest sensor reading time.";
+const char SEND_WATER_TANK_REFILL_NOTIFICATION_ERROR_MESSAGE[] PROGMEM = "Failed to send water tank refill notification.";
+const char SEND_SOIL_MOISTURE_STATUS_WET_MESSAGE[] PROGMEM = "Status: high soil moisture.";
+const char SEND_SOIL_MOISTURE_STATUS_OPTIMAL_MESSAGE[] PROGMEM = "Status: optimal soil moisture.";
+const char SEND_SOIL_MOISTURE_STATUS_DRY_MESSAGE[] PROGMEM = "Status: low soil moisture.";
+
+// Function for mapping severity to priority lane
+EventLane EventModule::getLane(const String& severity) {
+    if (severity == ERROR) {
+        return LANE_ERROR;
+    } else if (severity == WARNING) {
+        return LANE_WARNING;
+    }
+    return LANE_INFO;
+}
+
+// Function for finding oldest event of a lane
+int EventModule::findOldestSlot(EventLane lane) const {
+    int oldest = -1;
+    for (int i = 0; i < MAX_EVENTS; i++) {
+        if (slotUsed[i] && slotLanes[i] == lane && (oldest < 0 || slotSequences[i] < slotSequences[oldest])) {
+            oldest = i;
+        }
+    }
+    return oldest;
+}
+
+// Function for merging repeated event into queued record with same type and message
+bool EventModule::coalesceEvent(const Event &event) {
+    for (int i = 0; i < MAX_EVENTS; i++) {
+        if (slotUsed[i] && eventBuffer[i].eventType == event.eventType && eventBuffer[i].message == event.message) {
+            eventBuffer[i].count++;
+            eventBuffer[i].lastTimestamp = event.timestamp;
+            stats.coalesced++;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Function for enqueuing an event into its priority lane
 bool EventModule::enqueueEvent(const Event &event) {
+    if (coalesceEvent(event)) {
+        return true; // Merged into existing record, no slot needed
+    }
+
+    EventLane lane = getLane(event.severity);
+    int slot = -1;
     if (numEvents < MAX_EVENTS) {
-        eventBuffer[bufferEnd] = event;
-        bufferEnd = (bufferEnd + 1) % MAX_EVENTS;
-        numEvents++;
-        return true;
+        // Take any free slot
+        for (int i = 0; i < MAX_EVENTS && slot < 0; i++) {
+            if (!slotUsed[i]) {
+                slot = i;
+            }
+        }
+    } else {
+        // Evict oldest event from the lowest priority lane that is not above the new event
+        for (int evictLane = NUM_EVENT_LANES - 1; evictLane >= lane && slot < 0; evictLane--) {
+            slot = findOldestSlot((EventLane)evictLane);
+        }
+        if (slot < 0) {
+            stats.dropped++;
+            return false; // Queue holds only higher priority events
+        }
+        slotUsed[slot] = false;
+        numEvents--;
+        stats.evicted++;
     }
-    return false; // Buffer is full
+
+    eventBuffer[slot] = event;
+    slotLanes[slot] = lane;
+    slotSequences[slot] = nextSequence++;
+    slotUsed[slot] = true;
+    numEvents++;
+    stats.enqueued++;
+    return true;
 }
 
-// Function for dequeuing the next event from the circular buffer
+// Function for dequeuing the oldest event of the highest priority lane
 bool EventModule::dequeueEvent(Event &event) {
-    if (numEvents > 0) {
-        event = eventBuffer[bufferStart];
-        bufferStart = (bufferStart + 1) % MAX_EVENTS;
-        numEvents--;
-        return true;
+    for (int lane = 0; lane < NUM_EVENT_LANES; lane++) {
+        int slot = findOldestSlot((EventLane)lane);
+        if (slot >= 0) {
+            event = eventBuffer[slot];
+            eventBuffer[slot] = Event(); // Release strings held by the slot
+            slotUsed[slot] = false;
+            numEvents--;
+            return true;
+        }
     }
     return false; // No events in the buffer
 }
 
+// Function for getting queue counters
+const EventQueueStats& EventModule::getStats() const {
+    return stats;
+}
+
+// Function for getting queued event of slot, nullptr if slot is free
+const Event* EventModule::getQueuedEvent(int slot) const {
+    if (slot < 0 || slot >= MAX_EVENTS || !slotUsed[slot]) {
+        return nullptr;
+    }
+    return &eventBuffer[slot];
+}
+
 // Function for creating and enqueuing event
 void EventModule::createAndEnqueueEvent(
     const String& timestamp, 
@@ -44,9 +149,9 @@ void EventModule::createAndEnqueueEvent(
 ) {
     Event event = createEvent(timestamp, hostname, severity, facility, message, ssid, eventType);
     if (enqueueEvent(event)) {
-        Serial.println("Event enqueued successfully.");
+        LOG_DEBUG("Event enqueued successfully.");
     } else {
-        Serial.println("Event queue is full. Event not enqueued.");
+        LOG_WARNING("Event queue is full of higher priority events. Event not enqueued.");
     }
 }
 
@@ -66,24 +171,47 @@ Event EventModule::createEvent(
     event.severity = severity;
     event.facility = facility;
     event.message = message;
+    if (event.message.length() > EVENT_MESSAGE_LIMIT) {
+        LOG_WARNING("Event message cut to %d characters.", EVENT_MESSAGE_LIMIT);
+        event.message = event.message.substring(0, EVENT_MESSAGE_LIMIT); // Encrypted slot is sized for this length
+    }
     event.messageId = generateMessageId(eventType);
     event.ssid = ssid;
+    event.eventType = eventType;
+    event.lastTimestamp = timestamp;
+    event.count = 1;
     return event;
 }
 
 // Function for generating messageId
 String EventModule::generateMessageId(const String& eventType) {
-    String messageId = getCurrentTimeAsString() + ":" + eventType;
-    return messageId;
+    char currentTime[EPOCH_STRING_LENGTH]; // Create array to store current time
+    getCurrentTimeAsString(currentTime, sizeof(currentTime));
+    PathBuilder messageId;
+    messageId.add(currentTime).add(":").add(eventType);
+    return String(messageId.c_str());
 }
 
 // Function for sending event to firebase
 void EventModule::sendEventToFirebase(const Event &event) {    
-    char encryptedHostname[INPUT_BUFFER_LIMIT] = {0}; // Create array to store encrypted host name
-    char encryptedSeverity[INPUT_BUFFER_LIMIT] = {0}; // Create array to store encrypted severity
-    char encryptedFacility[INPUT_BUFFER_LIMIT] = {0}; // Create array to store encrypted facility
-    char encryptedMessage[INPUT_BUFFER_LIMIT] = {0}; // Create array to store encrypted message
-    char encryptedWifiSSID[INPUT_BUFFER_LIMIT] = {0}; // Create array to store encrypted WiFi SSID
+    ArenaScope arenaScope(cycleArena); // Free encryption and payload buffers on return
+    // Message slot is sized from hex length of longest message, other fields are short and fit INPUT_BUFFER_LIMIT
+    if (event.message.length() > EVENT_MESSAGE_LIMIT || ENCRYPTED_HEX_LENGTH(event.message.length()) > ENCRYPTED_MESSAGE_LENGTH) {
+        LOG_ERROR("Event message too long to encrypt. Event not sent.");
+        return;
+    }
+    const size_t fieldsLength = 4 * INPUT_BUFFER_LIMIT + ENCRYPTED_MESSAGE_LENGTH;
+    char* encryptedFields = cycleArena.allocateChars(fieldsLength); // Create arena block for encrypted fields
+    if (encryptedFields == nullptr) {
+        LOG_ERROR("Cycle arena exhausted. Event not sent.");
+        return;
+    }
+    memset(encryptedFields, 0, fieldsLength);
+    char* encryptedHostname = encryptedFields; // Encrypted host name
+    char* encryptedSeverity = encryptedFields + INPUT_BUFFER_LIMIT; // Encrypted severity
+    char* encryptedFacility = encryptedFields + 2 * INPUT_BUFFER_LIMIT; // Encrypted facility
+    char* encryptedWifiSSID = encryptedFields + 3 * INPUT_BUFFER_LIMIT; // Encrypted WiFi SSID
+    char* encryptedMessage = encryptedFields + 4 * INPUT_BUFFER_LIMIT; // Encrypted message, ENCRYPTED_MESSAGE_LENGTH
 
     // Gather and encrypt event information
     gatherAndEcryptEventInformation(
@@ -95,25 +223,45 @@ void EventModule::sendEventToFirebase(const Event &event) {
       encryptedWifiSSID
     );
     
-    FirebaseJson json; // Create a FirebaseJson object to hold the data
-
-    // Add encrypted data to the JSON object using identifiers
-    json.set(event.messageId + "/timestamp", event.timestamp);
-    json.set(event.messageId + "/hostname", encryptedHostname);
-    json.set(event.messageId + "/severity", encryptedSeverity);
-    json.set(event.messageId + "/facility", encryptedFacility);
-    json.set(event.messageId + "/message", encryptedMessage);
-    json.set(event.messageId + "/messageId", event.messageId.c_str());
-    json.set(event.messageId + "/ssid", encryptedWifiSSID);
-
-    String encryptedWifiSSIDString(encryptedWifiSSID); // Create String object to hold the encrypted WiFi SSID data
-
-    // Create nodepath and send data to firebase
-    String nodePath = "events/" + event.severity + "/" + getFormattedDate() + encryptedWifiSSIDString + "/" + getDeviceId() + "/";
-    if (sendFirebaseData(json, nodePath.c_str())) {
-        Serial.println("Event data sent successfully.");
+    JsonWriter json(cycleArena, JSON_PAYLOAD_LIMIT); // Create JsonWriter to serialize payload into arena buffer
+
+    // Add encrypted data to the JSON object using identifiers, keys share "<messageId>/" prefix
+    PathBuilder key;
+    key.add(event.messageId).add("/");
+    size_t prefixLength = key.length();
+    json.set(key.add("timestamp").c_str(), event.timestamp);
+    key.truncate(prefixLength);
+    json.set(key.add("hostname").c_str(), encryptedHostname);
+    key.truncate(prefixLength);
+    json.set(key.add("severity").c_str(), encryptedSeverity);
+    key.truncate(prefixLength);
+    json.set(key.add("facility").c_str(), encryptedFacility);
+    key.truncate(prefixLength);
+    json.set(key.add("message").c_str(), encryptedMessage);
+    key.truncate(prefixLength);
+    json.set(key.add("messageId").c_str(), event.messageId.c_str());
+    key.truncate(prefixLength);
+    json.set(key.add("ssid").c_str(), encryptedWifiSSID);
+    key.truncate(prefixLength);
+    json.set(key.add("count").c_str(), (int)event.count);
+    if (event.count > 1) {
+        key.truncate(prefixLength);
+        json.set(key.add("lastTimestamp").c_str(), event.lastTimestamp);
+    }
+
+    // Create nodepath and send data with selected transport
+    char formattedDate[FORMATTED_DATE_LENGTH]; // Create array to store formatted date
+    getFormattedDate(formattedDate, sizeof(formattedDate));
+    PathBuilder nodePath;
+    nodePath.add("events/").add(event.severity).add("/").add(formattedDate).add(encryptedWifiSSID).add("/").add(deviceId).add("/");
+    if (key.overflowed()) {
+        LOG_ERROR("Event key cut off. Event not sent.");
+        return; // Fields would land under wrong message id
+    }
+    if (transport.send(json, nodePath)) {
+        LOG_DEBUG("Event data sent successfully.");
     } else {
-        Serial.println("Failed to send event data.");
+        LOG_ERROR("Failed to send event data.");
     }
 }
 
@@ -126,34 +274,36 @@ void EventModule::gatherAndEcryptEventInformation(
   char* encryptedMessage, 
   char* encryptedWifiSSID
 ) {
-    byte temp_enc_iv[N_BLOCK]; // Create array to store temporary initialization vector
+    cipherCache.encrypt(CACHED_EVENT_HOSTNAME, event.hostname.c_str(), encryptedHostname); // Encrypt hostname once
+    cipherCache.encrypt(CACHED_EVENT_FACILITY, event.facility.c_str(), encryptedFacility); // Encrypt facility once
+    encryptSeverityAndMessage(event, encryptedSeverity, encryptedMessage);
+    cipherCache.encrypt(CACHED_EVENT_SSID, event.ssid.c_str(), encryptedWifiSSID); // Encrypt network name once per SSID
+}
 
-    generateNewIV(temp_enc_iv, enc_ivs[9]); // Generate a new IV for encryption
-    encryptAndConvertToHex(event.hostname.c_str(), encryptedHostname, temp_enc_iv); // Encrypt hostname and convert to hex
+// Function for encrypting fields that change with every event, also used by local server
+void EventModule::encryptSeverityAndMessage(const Event &event, char* encryptedSeverity, char* encryptedMessage) const {
+    byte temp_enc_iv[N_BLOCK]; // Create array to store temporary initialization vector
 
     generateNewIV(temp_enc_iv, enc_ivs[10]); // Generate a new IV for encryption
     encryptAndConvertToHex(event.severity.c_str(), encryptedSeverity, temp_enc_iv); // Encrypt severity and convert to hex
 
-    generateNewIV(temp_enc_iv, enc_ivs[11]); // Generate a new IV for encryption
-    encryptAndConvertToHex(event.facility.c_str(), encryptedFacility, temp_enc_iv); // Encrypt facility and convert to hex
-
     generateNewIV(temp_enc_iv, enc_ivs[12]); // Generate a new IV for encryption
     encryptAndConvertToHex(event.message.c_str(), encryptedMessage, temp_enc_iv); // Encrypt message and convert to hex
-
-    generateNewIV(temp_enc_iv, enc_ivs[13]); // Generate a new IV for encryption
-    encryptAndConvertToHex(event.ssid.c_str(), encryptedWifiSSID, temp_enc_iv); // Encrypt network name and convert to hex
 }
 
 // Function to process and send events to firebase
 void EventModule::loop() {
-    // Check if there are events in the queue
-    if (numEvents > 0) {
-        Serial.println("Event count: ");
-        Serial.println(numEvents);
+    // Check if there are events in the queue, they stay queued while uploads are paused
+    if (numEvents > 0 && uploadBreaker.canRequest()) {
+        LOG_INFO("Event count: %d", numEvents);
         Event nextEvent;
         if (dequeueEvent(nextEvent)) {
             // Send the next event
+            CostScope costScope(COST_EVENT_DRAIN);
             sendEventToFirebase(nextEvent);
         }
+        cycleArena.reset(); // Event cycle is done, release all upload buffers
+        // Log queue counters so that lost and merged events are visible
+        LOG_INFO("Events coalesced: %lu, evicted: %lu, dropped: %lu", stats.coalesced, stats.evicted, stats.dropped);
     }
 }
@@ -10,6 +10,7 @@
 #define EVENT_MODULE_H
 
 #include <ESP8266WiFi.h>
+#include "../aes_module/aes_module.h"
 
 // Events
 #define INFO "INFO"
@@ -30,33 +31,58 @@
 #define LATEST_WATERING_TIME "0x9"
 #define WATER_TANK_REFILL_NOTIFICATION "0xA"
 #define LATEST_SENSOR_READING_TIME "0xB"
+#define WATCHDOG "0xC"
+#define UPLOAD_BREAKER "0xD"
+#define SENSOR_FAULT "0xE"
 
-// Event messages
-#define ADD_DEVICE_INFO_ERROR_MESSAGE "Failed to add device information."
-#define ADD_AUTHORIZED_DEVICE_PENDING_MESSAGE "Device is pending authorization. Data sending disabled."
-#define ADD_AUTHORIZED_DEVICE_ERROR_MESSAGE "Failed to add device to authorized devices"
-#define SEND_TEMPERATURE_ERROR_MESSAGE "Failed to send temperature data."
-#define SEND_HUMIDITY_ERROR_MESSAGE "Failed to send humidity data."
-#define SEND_AIR_PRESSURE_ERROR_MESSAGE "Failed to send air pressure data."
-#define SEND_SOIL_MOISTURE_ERROR_MESSAGE "Failed to send soil moisture data."
-#define SEND_LUMINOSITY_ERROR_MESSAGE "Failed to send luminosity data."
-#define SEND_WATER_TANK_LEVEL_ERROR_MESSAGE "Failed to send water tank level data."
-#define SEND_LATEST_WATERING_TIME_ERROR_MESSAGE "Failed to send latest watering time."
-#define SEND_LATEST_SENSOR_READING_TIME_ERROR_MESSAGE "Failed to send latest sensor reading time."
-#define SEND_WATER_TANK_REFILL_NOTIFICATION_ERROR_MESSAGE "Failed to send water tank refill notification."
-#define SEND_SOIL_MOISTURE_STATUS_WET_MESSAGE "Status: high soil moisture."
-#define SEND_SOIL_MOISTURE_STATUS_OPTIMAL_MESSAGE "Status: optimal soil moisture."
-#define SEND_SOIL_MOISTURE_STATUS_DRY_MESSAGE "Status: low soil moisture."
+#define EVENT_MESSAGE_LIMIT (INPUT_BUFFER_LIMIT - 1) // Longest message, longer ones are cut before queueing
+#define ENCRYPTED_MESSAGE_LENGTH ENCRYPTED_HEX_LENGTH(EVENT_MESSAGE_LIMIT) // Hex slot of encrypted message
+
+// Event messages, kept in flash and defined in event_module.cpp
+extern const char ADD_DEVICE_INFO_ERROR_MESSAGE[];
+extern const char ADD_AUTHORIZED_DEVICE_PENDING_MESSAGE[];
+extern const char ADD_AUTHORIZED_DEVICE_ERROR_MESSAGE[];
+extern const char SEND_TEMPERATURE_ERROR_MESSAGE[];
+extern const char SEND_HUMIDITY_ERROR_MESSAGE[];
+extern const char SEND_AIR_PRESSURE_ERROR_MESSAGE[];
+extern const char SEND_SOIL_MOISTURE_ERROR_MESSAGE[];
+extern const char SEND_LUMINOSITY_ERROR_MESSAGE[];
+extern const char SEND_WATER_TANK_LEVEL_ERROR_MESSAGE[];
+extern const char SEND_LATEST_WATERING_TIME_ERROR_MESSAGE[];
+extern const char SEND_LATEST_SENSOR_READING_TIME_ERROR_MESSAGE[];
+extern const char SEND_WATER_TANK_REFILL_NOTIFICATION_ERROR_MESSAGE[];
+extern const char SEND_SOIL_MOISTURE_STATUS_WET_MESSAGE[];
+extern const char SEND_SOIL_MOISTURE_STATUS_OPTIMAL_MESSAGE[];
+extern const char SEND_SOIL_MOISTURE_STATUS_DRY_MESSAGE[];
 
 // Structure to represent an event
 struct Event {
-    String timestamp;
+    String timestamp; // Time of first occurrence
+    String lastTimestamp; // Time of latest occurrence when repeated events are coalesced
     String hostname;
     String severity;
     String facility;
     String message;
     String messageId;
     String ssid;
+    String eventType;
+    unsigned int count; // Number of coalesced occurrences
+};
+
+// Priority lanes, lower value is sent first and evicted last
+enum EventLane {
+    LANE_ERROR,
+    LANE_WARNING,
+    LANE_INFO,
+    NUM_EVENT_LANES
+};
+
+// Structure to represent event queue counters for diagnostics
+struct EventQueueStats {
+    unsigned long enqueued; // Events stored as new records
+    unsigned long coalesced; // Events merged into an existing record
+    unsigned long evicted; // Queued lower priority events removed to make room
+    unsigned long dropped; // New events rejected because queue held only higher priority events
 };
 
 const int MAX_EVENTS = 10; // Maximum number of events that can be stored
@@ -71,15 +97,36 @@ public:
                                const String& severity, const String& facility,
                                const String& message, const String& ssid,
                                const String& eventType); 
+
+    // Function declaration for getStats
+    const EventQueueStats& getStats() const;
+
+    // Function declaration for getQueuedEvent, slots 0 to MAX_EVENTS - 1
+    const Event* getQueuedEvent(int slot) const;
+
+    // Function declaration for encryptSeverityAndMessage, same ciphertext as uploaded, message slot is ENCRYPTED_MESSAGE_LENGTH
+    void encryptSeverityAndMessage(const Event &event, char* encryptedSeverity, char* encryptedMessage) const;
 private:
-    Event eventBuffer[MAX_EVENTS]; // Circular buffer to store events
-    int bufferStart = 0; // Index for the start of buffer
-    int bufferEnd = 0; // Index for the end of buffer
+    Event eventBuffer[MAX_EVENTS]; // Slots shared by all priority lanes
+    EventLane slotLanes[MAX_EVENTS]; // Lane of event in each slot
+    unsigned long slotSequences[MAX_EVENTS]; // Insertion order of event in each slot
+    bool slotUsed[MAX_EVENTS] = {false}; // Slot holds an event
+    unsigned long nextSequence = 0; // Sequence number for next stored event
     int numEvents = 0; // Number of events in buffer
+    EventQueueStats stats = {0, 0, 0, 0}; // Queue counters
 
     // Function declaration for enqueueEvent
     bool enqueueEvent(const Event &event);
 
+    // Function declaration for coalesceEvent
+    bool coalesceEvent(const Event &event);
+
+    // Function declaration for findOldestSlot, returns -1 if lane is empty
+    int findOldestSlot(EventLane lane) const;
+
+    // Function declaration for getLane
+    static EventLane getLane(const String& severity);
+
     // Function declaration for dequeueEvent
     bool dequeueEvent(Event &event);
 
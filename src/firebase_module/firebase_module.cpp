@@ -4,22 +4,73 @@
  * Date: 1.9.2023
  * Description: This file contains implementation of FirebaseModule.
  * Provides functionality for sending data to firebase and checking device authorization status.
- * Uses FirebaseESP8266 library.
+ * Writes are sent as REST PATCH requests with body from JsonWriter, reads use FirebaseESP8266 library.
  */
 
 #include "firebase_module.h"
 #include "../../config/config.h" // Include configuration file
+#include "../path_builder/path_builder.h"
+#include "../watchdog_module/watchdog_module.h"
+#include "../log_module/log_module.h"
+#include <ESP8266HTTPClient.h>
+
+#define LOG_TAG "firebase"
 
 FirebaseData firebaseData;
+BearSSL::WiFiClientSecure restClient; // TLS client for REST writes
+HTTPClient restHttp;
+FirebaseWriteStats writeStats[NUM_FIREBASE_TREES] = {}; // Write load per tree since boot
+const char* const TREE_NAMES[NUM_FIREBASE_TREES] = {"devices", "history", "events", "notifications", "other"};
 
 // Function for initializing Firebase module
 void firebaseModuleInit() {
    Firebase.begin(FIREBASE_HOST, FIREBASE_AUTH);
+   restClient.setInsecure(); // Same as FirebaseESP8266 default, certificate is not verified
+   restClient.setBufferSizes(4096, 1024); // Responses to silent writes are small
+}
+
+// Function for resolving tree of node path
+FirebaseTree getFirebaseTree(const char* nodePath) {
+    for (int i = 0; i < TREE_OTHER; i++) {
+        size_t length = strlen(TREE_NAMES[i]);
+        if (strncmp(nodePath, TREE_NAMES[i], length) == 0 && nodePath[length] == '/') {
+            return (FirebaseTree)i;
+        }
+    }
+    return TREE_OTHER;
+}
+
+// Function for accounting successful write to its tree
+void recordFirebaseWrite(const JsonWriter& json, const char* nodePath, unsigned long elapsedMicros) {
+    FirebaseWriteStats& stats = writeStats[getFirebaseTree(nodePath)];
+    stats.writes++;
+    stats.bytes += strlen(nodePath) + json.length();
+    stats.nodes += json.fieldCount();
+    stats.micros += elapsedMicros;
 }
 
 // Function for sending data specific nodepath in Firebase
-bool sendFirebaseData(FirebaseJson json, const char* nodePath) {
-    if (Firebase.updateNode(firebaseData, nodePath, json)) {
+// Payload is PATCHed as is through REST API, so no JSON tree is built or copied on the way
+bool sendFirebaseData(const JsonWriter& json, const PathBuilder& nodePath) {
+    WatchdogScope watchdogScope(STAGE_FIREBASE_WRITE);
+    unsigned long startMicros = micros();
+
+    // print=silent makes the server answer 204 without echoing the payload back
+    char url[FIREBASE_URL_LIMIT];
+    int urlLength = snprintf(url, sizeof(url), "https://%s/%s.json?print=silent&auth=%s", FIREBASE_HOST, nodePath.c_str(), FIREBASE_AUTH);
+    if (urlLength < 0 || urlLength >= (int)sizeof(url) || nodePath.overflowed() || json.overflowed()) {
+        return false; // Path or payload was cut off, never write partial data
+    }
+
+    restHttp.setReuse(true); // Keep TLS connection open between writes
+    if (!restHttp.begin(restClient, url)) {
+        return false;
+    }
+    int httpCode = restHttp.sendRequest("PATCH", (const uint8_t*)json.c_str(), json.length());
+    restHttp.end();
+
+    if (httpCode == HTTP_CODE_OK || httpCode == HTTP_CODE_NO_CONTENT) {
+        recordFirebaseWrite(json, nodePath.c_str(), micros() - startMicros);
         return true; // Data sent successfully
     } else {
         return false; // Failed to send data
@@ -27,18 +78,44 @@ bool sendFirebaseData(FirebaseJson json, const char* nodePath) {
 }
 
 // Function for checking authorization status of the device
-bool checkDeviceStatus(const String& deviceId) {
-    String nodePath = "authorized_devices/" + deviceId + "/authorized";
-    if (Firebase.getBool(firebaseData, nodePath)) {
-        bool isAuthorized = firebaseData.to<bool>();
-        if (isAuthorized) {
-            return true; // Device is authorized
-        }
+AuthorizationStatus checkDeviceStatus(const String& deviceId) {
+    WatchdogScope watchdogScope(STAGE_FIREBASE_READ);
+    PathBuilder nodePath;
+    nodePath.add("authorized_devices/").add(deviceId).add("/authorized");
+    if (Firebase.getBool(firebaseData, nodePath.c_str())) {
+        return firebaseData.to<bool>() ? AUTHORIZATION_GRANTED : AUTHORIZATION_PENDING;
     }
-    return false; // Device is not authorized
+    // Missing node is answered with null, any other failure tells nothing about the state
+    if (firebaseData.httpCode() == HTTP_CODE_OK && firebaseData.dataType() == "null") {
+        return AUTHORIZATION_NOT_REGISTERED;
+    }
+    return AUTHORIZATION_UNKNOWN;
 }
 
 // Function for checking if a device is authorized based on its device ID
-bool isDeviceAuthorized(const String& deviceId) {
+AuthorizationStatus isDeviceAuthorized(const String& deviceId) {
     return checkDeviceStatus(deviceId);
 }
+
+// Function for getting write statistics of a tree
+const FirebaseWriteStats& getFirebaseWriteStats(FirebaseTree tree) {
+    return writeStats[tree];
+}
+
+// Function for printing write statistics of all trees with write rate since boot
+void printFirebaseWriteStats() {
+    unsigned long uptimeSeconds = millis() / 1000;
+    FirebaseWriteStats total = {0, 0, 0, 0};
+    for (int i = 0; i < NUM_FIREBASE_TREES; i++) {
+        total.writes += writeStats[i].writes;
+        total.bytes += writeStats[i].bytes;
+        total.nodes += writeStats[i].nodes;
+        // Rate in ten thousandths of writes per second, integer format keeps float out of the logger
+        unsigned long rate = uptimeSeconds > 0 ? (unsigned long)((uint64_t)writeStats[i].writes * 10000 / uptimeSeconds) : 0;
+        LOG_DEBUG("Writes %s: %lu writes (%lu.%04lu/s), %lu bytes, %lu nodes, %lu us per write",
+                  TREE_NAMES[i], (unsigned long)writeStats[i].writes, rate / 10000, rate % 10000,
+                  (unsigned long)writeStats[i].bytes, (unsigned long)writeStats[i].nodes,
+                  (unsigned long)(writeStats[i].writes > 0 ? writeStats[i].micros / writeStats[i].writes : 0));
+    }
+    LOG_INFO("Writes total: %lu writes, %lu bytes, %lu nodes", total.writes, total.bytes, total.nodes);
+}
@@ -10,6 +10,36 @@
 #define FIREBASE_MODULE_H
 
 #include <FirebaseESP8266.h>
+#include "../json_writer/json_writer.h"
+#include "../path_builder/path_builder.h"
+
+#define FIREBASE_URL_LIMIT 384 // Host, node path and auth query of a REST request
+
+// Database trees that writes are accounted to
+enum FirebaseTree {
+    TREE_DEVICES,
+    TREE_HISTORY,
+    TREE_EVENTS,
+    TREE_NOTIFICATIONS,
+    TREE_OTHER,
+    NUM_FIREBASE_TREES
+};
+
+// Structure to represent write load caused by this device on one tree
+struct FirebaseWriteStats {
+    unsigned long writes; // Number of updateNode requests
+    unsigned long bytes; // Path and JSON payload bytes
+    unsigned long nodes; // Leaf values written, equals node growth for new paths
+    unsigned long micros; // Time spent in requests
+};
+
+// Result of authorization check
+enum AuthorizationStatus {
+    AUTHORIZATION_GRANTED, // authorized is true
+    AUTHORIZATION_PENDING, // Device is registered, authorized is false
+    AUTHORIZATION_NOT_REGISTERED, // Server answered that authorized node does not exist
+    AUTHORIZATION_UNKNOWN // Request failed, nothing is known about the state
+};
 
 // Global FirebaseData object for Firebase interactions
 extern FirebaseData firebaseData;
@@ -18,9 +48,15 @@ extern FirebaseData firebaseData;
 void firebaseModuleInit();
 
 // Function for sending data to firebase
-bool sendFirebaseData(FirebaseJson json, const char* nodePath);
+bool sendFirebaseData(const JsonWriter& json, const PathBuilder& nodePath);
 
 // Function for checking device authorization
-bool isDeviceAuthorized(const String &deviceId);
+AuthorizationStatus isDeviceAuthorized(const String &deviceId);
+
+// Function for getting write statistics of a tree since boot
+const FirebaseWriteStats& getFirebaseWriteStats(FirebaseTree tree);
+
+// Function for printing write statistics of all trees
+void printFirebaseWriteStats();
 
 #endif
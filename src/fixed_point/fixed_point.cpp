@@ -0,0 +1,80 @@
+/**
+ * File: fixed_point.cpp
+ * Author: Joonas Nislin
+ * Date: 19.10.2026
+ * Description: This file contains implementation of FixedPoint.
+ * ESP8266 has no FPU, so every float multiply, divide and dtostrf call is emulated in software.
+ * Values are kept as integer hundredths and only converted from float at sensor library boundary.
+ */
+
+#include "fixed_point.h"
+
+// Function for creating value from hundredths
+FixedPoint FixedPoint::fromHundredths(int32_t hundredths) {
+    FixedPoint value;
+    value.hundredths = hundredths;
+    value.valid = true;
+    return value;
+}
+
+// Function for creating value from whole number
+FixedPoint FixedPoint::fromInt(int32_t value) {
+    return fromHundredths(value * FIXED_POINT_SCALE);
+}
+
+// Function for creating value from float, rounded half away from zero
+FixedPoint FixedPoint::fromFloat(float value) {
+    if (isnan(value) || isinf(value)) {
+        return invalid();
+    }
+    float scaled = value * FIXED_POINT_SCALE;
+    return fromHundredths((int32_t)(scaled < 0 ? scaled - 0.5F : scaled + 0.5F));
+}
+
+// Function for creating invalid value
+FixedPoint FixedPoint::invalid() {
+    return FixedPoint();
+}
+
+// Function for checking if value holds a reading
+bool FixedPoint::isValid() const {
+    return valid;
+}
+
+// Function for getting value in hundredths
+int32_t FixedPoint::toHundredths() const {
+    return hundredths;
+}
+
+// Function for formatting value right aligned to width with two decimals
+size_t FixedPoint::format(char* buffer, size_t size, int width) const {
+    int length;
+    if (!valid) {
+        length = snprintf(buffer, size, "%*s", width, "nan");
+    } else {
+        // Split with unsigned magnitude so INT32_MIN does not overflow
+        uint32_t magnitude = hundredths < 0 ? 0U - (uint32_t)hundredths : (uint32_t)hundredths;
+        char digits[16];
+        snprintf(digits, sizeof(digits), "%s%lu.%02lu", hundredths < 0 ? "-" : "",
+                 (unsigned long)(magnitude / FIXED_POINT_SCALE), (unsigned long)(magnitude % FIXED_POINT_SCALE));
+        length = snprintf(buffer, size, "%*s", width, digits);
+    }
+    return length < 0 ? 0 : (size_t)length;
+}
+
+// Comparison operators, invalid values compare by their zero hundredths
+bool FixedPoint::operator<(const FixedPoint& other) const {
+    return hundredths < other.hundredths;
+}
+
+bool FixedPoint::operator<=(const FixedPoint& other) const {
+    return hundredths <= other.hundredths;
+}
+
+bool FixedPoint::operator>(const FixedPoint& other) const {
+    return hundredths > other.hundredths;
+}
+
+bool FixedPoint::operator>=(const FixedPoint& other) const {
+    return hundredths >= other.hundredths;
+}
@@ -0,0 +1,47 @@
+/**
+ * File: fixed_point.h
+ * Author: Joonas Nislin
+ * Date: 19.10.2026
+ * Description: This file contains header file of FixedPoint.
+ * Holds declarations for sensor values stored as signed hundredths, so conversions and
+ * formatting run on integer instructions instead of soft-float.
+ */
+
+#ifndef FIXED_POINT_H
+#define FIXED_POINT_H
+
+#include <ESP8266WiFi.h>
+
+#define FIXED_POINT_SCALE 100 // Two decimals, same precision as uploaded strings
+
+class FixedPoint {
+public:
+    // Value from hundredths, e.g. 2150 is 21.50
+    static FixedPoint fromHundredths(int32_t hundredths);
+
+    // Value from whole number
+    static FixedPoint fromInt(int32_t value);
+
+    // Value from float returned by sensor library, NaN gives invalid value
+    static FixedPoint fromFloat(float value);
+
+    // Value for failed reading
+    static FixedPoint invalid();
+
+    bool isValid() const;
+    int32_t toHundredths() const;
+
+    // Format like dtostrf(value, width, 2), invalid value is formatted as "nan"
+    size_t format(char* buffer, size_t size, int width = 6) const;
+
+    bool operator<(const FixedPoint& other) const;
+    bool operator<=(const FixedPoint& other) const;
+    bool operator>(const FixedPoint& other) const;
+    bool operator>=(const FixedPoint& other) const;
+
+private:
+    int32_t hundredths = 0;
+    bool valid = false;
+};
+
+#endif
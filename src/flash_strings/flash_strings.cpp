@@ -0,0 +1,25 @@
+/**
+ * File: flash_strings.cpp
+ * Author: Joonas Nislin
+ * Date: 19.10.2026
+ * Description: This file contains implementation of FlashStrings.
+ * Provides functionality for using strings kept in flash.
+ * Flash can only be read in aligned 32-bit words, so these strings are never passed to plain str* functions.
+ */
+
+#include "flash_strings.h"
+
+// Function for copying flash string into buffer
+size_t copyFlashString(char* buffer, size_t size, PGM_P flashString) {
+    if (size == 0) {
+        return 0;
+    }
+    strncpy_P(buffer, flashString, size - 1);
+    buffer[size - 1] = '\0';
+    return strlen(buffer);
+}
+
+// Function for comparing RAM string with flash string
+bool equalsFlashString(const char* string, PGM_P flashString) {
+    return strcmp_P(string, flashString) == 0;
+}
@@ -0,0 +1,20 @@
+/**
+ * File: flash_strings.h
+ * Author: Joonas Nislin
+ * Date: 19.10.2026
+ * Description: This file contains header file of FlashStrings.
+ * Holds helper declarations for strings kept in flash with PROGMEM.
+ */
+
+#ifndef FLASH_STRINGS_H
+#define FLASH_STRINGS_H
+
+#include <Arduino.h>
+
+// Copy flash string into buffer, result is always terminated, returns copied length
+size_t copyFlashString(char* buffer, size_t size, PGM_P flashString);
+
+// Compare RAM string with flash string
+bool equalsFlashString(const char* string, PGM_P flashString);
+
+#endif
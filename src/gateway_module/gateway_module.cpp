@@ -0,0 +1,228 @@
+/**
+ * File: gateway_module.cpp
+ * Author: Joonas Nislin
+ * Date: 19.10.2026
+ * Description: This file contains implementation of GatewayModule.
+ * Provides functionality for gateway role, where one device uploads readings of several sensor nodes:
+ * - Only nodes listed in GATEWAY_NODE_MACS are paired, they are added as encrypted peers when GATEWAY_NODE_KEY is set
+ * - Nodes send NodePacket frames over ESP-NOW, receive callback only copies them into a ring buffer
+ * - Main loop drops frames of unpaired senders and frames shorter or longer than their value count,
+ *   then drops repeated sequences and keeps latest value of every metric per node
+ * - Every UPLOAD_INTERVAL pending values of each node are uploaded as one request under node MAC
+ * Nodes must send on the WiFi channel of the access point the gateway is connected to.
+ */
+
+#include <espnow.h>
+#include "gateway_module.h"
+#include "../globals/globals.h"
+#include "../log_module/log_module.h"
+
+#define LOG_TAG "gateway"
+
+GatewayModule gateway;
+EspNowLink espNowLink;
+
+// Frames queued by receive callback, taken by main loop
+NodeFrame frameQueue[GATEWAY_FRAME_QUEUE];
+volatile uint8_t frameHead = 0; // Next slot written by callback
+volatile uint8_t frameTail = 0; // Next slot read by main loop
+volatile unsigned long droppedFrames = 0;
+
+// Function for starting ESP-NOW and adding paired nodes as peers
+bool EspNowLink::begin() {
+    if (esp_now_init() != 0) {
+        LOG_ERROR("ESP-NOW init failed");
+        return false;
+    }
+    esp_now_set_self_role(ESP_NOW_ROLE_COMBO);
+
+    // Peers with key only accept frames encrypted with it, all zero key means frames are not encrypted
+    bool keySet = false;
+    for (size_t i = 0; i < sizeof(GATEWAY_NODE_KEY); i++) {
+        keySet = keySet || GATEWAY_NODE_KEY[i] != 0;
+    }
+    if (!keySet) {
+        LOG_WARNING("GATEWAY_NODE_KEY not set, node frames are not encrypted");
+    }
+    for (size_t i = 0; i < sizeof(GATEWAY_NODE_MACS) / sizeof(GATEWAY_NODE_MACS[0]); i++) {
+        if (esp_now_add_peer((uint8_t*)GATEWAY_NODE_MACS[i], ESP_NOW_ROLE_COMBO, 0,
+                             keySet ? (uint8_t*)GATEWAY_NODE_KEY : nullptr, keySet ? sizeof(GATEWAY_NODE_KEY) : 0) != 0) {
+            LOG_ERROR("Failed to add paired node as ESP-NOW peer");
+        }
+    }
+    esp_now_register_recv_cb(onReceive);
+    return true;
+}
+
+// Function for copying received frame into queue
+void EspNowLink::onReceive(uint8_t* mac, uint8_t* data, uint8_t length) {
+    uint8_t next = (frameHead + 1) % GATEWAY_FRAME_QUEUE;
+    if (next == frameTail || length > sizeof(NodePacket)) {
+        droppedFrames++; // Queue full or frame is not a node packet
+        return;
+    }
+    NodeFrame& frame = frameQueue[frameHead];
+    memcpy(frame.mac, mac, sizeof(frame.mac));
+    frame.length = length;
+    memset(&frame.packet, 0, sizeof(frame.packet));
+    memcpy(&frame.packet, data, length);
+    frameHead = next;
+}
+
+// Function for taking next frame from queue
+bool EspNowLink::receive(NodeFrame& frame) {
+    if (frameTail == frameHead) {
+        return false;
+    }
+    frame = frameQueue[frameTail];
+    frameTail = (frameTail + 1) % GATEWAY_FRAME_QUEUE;
+    return true;
+}
+
+// Function for getting number of frames lost in callback
+unsigned long EspNowLink::getDroppedFrames() const {
+    return droppedFrames;
+}
+
+// Function for starting gateway on link
+void GatewayModule::begin(NodeLink& link) {
+    this->link = &link;
+    if (link.begin()) {
+        LOG_INFO("Gateway listening for sensor nodes");
+    }
+    previousUploadMillis = millis();
+}
+
+// Function for taking received frames and uploading batches
+void GatewayModule::loop(const String& networkName) {
+    if (link == nullptr) {
+        return;
+    }
+
+    NodeFrame frame;
+    while (link->receive(frame)) {
+        acceptFrame(frame);
+    }
+
+    int queueDepth = getQueueDepth();
+    if (queueDepth > stats.maxQueueDepth) {
+        stats.maxQueueDepth = queueDepth;
+    }
+
+    unsigned long currentMillis = millis();
+    if (queueDepth > 0 && currentMillis - previousUploadMillis >= UPLOAD_INTERVAL) {
+        previousUploadMillis = currentMillis;
+        uploadBatches(networkName);
+    }
+}
+
+// Function for de-duplicating frame and merging its values into node
+void GatewayModule::acceptFrame(const NodeFrame& frame) {
+    const NodePacket& packet = frame.packet;
+    if (!isPaired(frame.mac)) {
+        stats.unpaired++; // Never write readings of an unknown sender under its claimed MAC
+        return;
+    }
+    if (packet.version != NODE_PACKET_VERSION || packet.count == 0 || packet.count > NODE_MAX_VALUES
+        || frame.length != NODE_PACKET_HEADER + packet.count * sizeof(NodeValue)) {
+        stats.rejected++; // Truncated frame would upload its zero fill as readings
+        return;
+    }
+
+    GatewayNode* node = findNode(frame.mac);
+    if (node == nullptr) {
+        stats.rejected++; // Node table is full
+        return;
+    }
+
+    // Node repeats a packet when it misses the link layer ack, restarted node begins a new sequence
+    if (node->count > 0 && packet.sequence == node->lastSequence) {
+        stats.duplicates++;
+        return;
+    }
+    node->lastSequence = packet.sequence;
+    stats.received++;
+
+    // Keep latest value of each metric until next batch
+    for (int i = 0; i < packet.count; i++) {
+        const NodeValue& value = packet.values[i];
+        if (value.metric >= NUM_NODE_METRICS) {
+            continue;
+        }
+        int slot = 0;
+        while (slot < node->count && node->values[slot].metric != value.metric) {
+            slot++;
+        }
+        if (slot == node->count) {
+            node->count++; // Metrics are unique, so slot is always below NODE_MAX_VALUES
+        }
+        node->values[slot] = value;
+    }
+    node->pending = true;
+}
+
+// Function for checking if sender is one of paired nodes
+bool GatewayModule::isPaired(const uint8_t* mac) {
+    for (size_t i = 0; i < sizeof(GATEWAY_NODE_MACS) / sizeof(GATEWAY_NODE_MACS[0]); i++) {
+        if (memcmp(GATEWAY_NODE_MACS[i], mac, sizeof(GATEWAY_NODE_MACS[i])) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Function for finding node by address
+GatewayNode* GatewayModule::findNode(const uint8_t* mac) {
+    for (int i = 0; i < numNodes; i++) {
+        if (memcmp(nodes[i].mac, mac, sizeof(nodes[i].mac)) == 0) {
+            return &nodes[i];
+        }
+    }
+    if (numNodes >= GATEWAY_MAX_NODES) {
+        return nullptr;
+    }
+
+    // Take free slot, device ID is formatted like WiFi.macAddress() of the node itself
+    GatewayNode& node = nodes[numNodes++];
+    memcpy(node.mac, mac, sizeof(node.mac));
+    snprintf(node.deviceId, sizeof(node.deviceId), "%02X:%02X:%02X:%02X:%02X:%02X",
+             mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+    node.lastSequence = 0;
+    node.pending = false;
+    node.count = 0;
+    return &node;
+}
+
+// Function for uploading pending values of every node
+void GatewayModule::uploadBatches(const String& networkName) {
+    for (int i = 0; i < numNodes; i++) {
+        GatewayNode& node = nodes[i];
+        if (!node.pending) {
+            continue;
+        }
+        if (apiManager.encryptAndSendNodeReadings(node.deviceId, node.values, node.count, networkName)) {
+            node.pending = false;
+            stats.batches++;
+        } else {
+            stats.failedBatches++; // Values stay pending and newer readings replace them
+        }
+    }
+}
+
+// Function for counting nodes waiting for upload
+int GatewayModule::getQueueDepth() const {
+    int depth = 0;
+    for (int i = 0; i < numNodes; i++) {
+        if (nodes[i].pending) {
+            depth++;
+        }
+    }
+    return depth;
+}
+
+// Function for printing gateway counters
+void GatewayModule::printStats() const {
+    LOG_INFO("%d nodes, %lu received, %lu duplicates, %lu rejected, %lu unpaired, %lu dropped, %lu batches, %lu failed, max queue %d",
+             numNodes, stats.received, stats.duplicates, stats.rejected, stats.unpaired,
+             link != nullptr ? link->getDroppedFrames() : 0UL, stats.batches, stats.failedBatches, stats.maxQueueDepth);
+}
@@ -0,0 +1,141 @@
+/**
+ * File: gateway_module.h
+ * Author: Joonas Nislin
+ * Date: 19.10.2026
+ * Description: This file contains header file of GatewayModule.
+ * Holds declarations for receiving readings of battery powered sensor nodes and uploading them in batches.
+ */
+
+#ifndef GATEWAY_MODULE_H
+#define GATEWAY_MODULE_H
+
+#include <ESP8266WiFi.h>
+
+#define GATEWAY_MAX_NODES 16 // Nodes tracked by one gateway
+#define NODE_MAX_VALUES 6 // Values in one node packet
+#define GATEWAY_FRAME_QUEUE 16 // Received frames waiting for main loop
+#define NODE_PACKET_VERSION 1
+
+// Metrics a node can send, value is in hundredths of the unit used by the device itself
+enum NodeMetric : uint8_t {
+    NODE_TEMPERATURE,
+    NODE_HUMIDITY,
+    NODE_AIR_PRESSURE,
+    NODE_SOIL_MOISTURE,
+    NODE_LUMINOSITY,
+    NODE_WATER_TANK_LEVEL,
+    NUM_NODE_METRICS
+};
+
+// Structure to represent one value in node packet
+struct __attribute__((packed)) NodeValue {
+    uint8_t metric; // NodeMetric
+    int32_t hundredths;
+};
+
+#define NODE_PACKET_HEADER 4 // Bytes before values in node packet
+
+// Structure to represent packet sent by node, 4 + 5 * count bytes on air
+struct __attribute__((packed)) NodePacket {
+    uint8_t version; // NODE_PACKET_VERSION
+    uint16_t sequence; // Incremented by node for every packet, repeated packet is a duplicate
+    uint8_t count; // Number of values
+    NodeValue values[NODE_MAX_VALUES];
+};
+
+// Structure to represent packet with sender address
+struct NodeFrame {
+    uint8_t mac[6];
+    uint8_t length; // Bytes received, packet is zero-filled after them
+    NodePacket packet;
+};
+
+// Link that delivers node frames, implemented by EspNowLink on the device
+class NodeLink {
+public:
+    virtual ~NodeLink() {}
+
+    // Start receiving, returns false if link could not be started
+    virtual bool begin() = 0;
+
+    // Take next received frame, returns false if none is waiting
+    virtual bool receive(NodeFrame& frame) = 0;
+
+    // Frames lost because queue was full
+    virtual unsigned long getDroppedFrames() const = 0;
+};
+
+// ESP-NOW link, frames are queued in receive callback and taken in main loop
+class EspNowLink : public NodeLink {
+public:
+    bool begin() override;
+    bool receive(NodeFrame& frame) override;
+    unsigned long getDroppedFrames() const override;
+
+private:
+    // Receive callback of ESP-NOW
+    static void onReceive(uint8_t* mac, uint8_t* data, uint8_t length);
+};
+
+// Structure to represent latest readings of one node
+struct GatewayNode {
+    uint8_t mac[6];
+    char deviceId[18]; // MAC as "AA:BB:CC:DD:EE:FF", same format as WiFi.macAddress()
+    uint16_t lastSequence;
+    bool pending; // Values not uploaded yet
+    uint8_t count;
+    NodeValue values[NODE_MAX_VALUES];
+};
+
+// Structure to represent gateway counters for diagnostics
+struct GatewayStats {
+    unsigned long received; // Frames accepted
+    unsigned long duplicates; // Frames with repeated sequence
+    unsigned long rejected; // Malformed or truncated frames or node table full
+    unsigned long unpaired; // Frames from senders not in GATEWAY_NODE_MACS
+    unsigned long batches; // Successful node uploads
+    unsigned long failedBatches; // Failed node uploads, values are kept for next batch
+    int maxQueueDepth; // Most nodes waiting for upload at once
+};
+
+class GatewayModule {
+public:
+    // Start receiving through link
+    void begin(NodeLink& link);
+
+    // Take received frames and upload batches when interval has passed
+    void loop(const String& networkName);
+
+    // Print counters
+    void printStats() const;
+
+private:
+    NodeLink* link = nullptr;
+    GatewayNode nodes[GATEWAY_MAX_NODES];
+    int numNodes = 0;
+    unsigned long previousUploadMillis = 0;
+    GatewayStats stats = {0, 0, 0, 0, 0, 0, 0};
+
+    // De-duplicate frame and merge its values into node
+    void acceptFrame(const NodeFrame& frame);
+
+    // Check if sender is one of paired nodes
+    static bool isPaired(const uint8_t* mac);
+
+    // Find node by address or take free slot for it
+    GatewayNode* findNode(const uint8_t* mac);
+
+    // Upload pending values of every node, one request per node
+    void uploadBatches(const String& networkName);
+
+    // Number of nodes waiting for upload
+    int getQueueDepth() const;
+
+    // Constants and Configuration Settings
+    const unsigned long UPLOAD_INTERVAL = 60L * 1000L; // Milliseconds between batches
+};
+
+extern GatewayModule gateway;
+extern EspNowLink espNowLink;
+
+#endif
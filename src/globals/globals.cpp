@@ -6,9 +6,22 @@
  */
 
 #include "globals.h"
+#include "../circuit_breaker/circuit_breaker.h"
+#include "../log_module/log_module.h"
 
 // Function for event creation
-void handleEvent(const char* severity, const char* message, const char* eventType) {
+void handleEvent(const char* severity, PGM_P message, const char* eventType) {
+    // Upload failures while uploads are paused are summarized by the breaker when it closes
+    if (uploadBreaker.isOpen() && strcmp(severity, ERROR) == 0) {
+        uploadBreaker.recordSuppressedEvent();
+        return;
+    }
     // Call eventModule createAndEnqueueEvent to create and enqueue event for sending to firebase
-    eventModule.createAndEnqueueEvent(getCurrentTimeAsString(), DEVICE_NAME, severity, DEVICE, message, getNetworkName(), eventType);
+    eventModule.createAndEnqueueEvent(getCurrentTimeAsString(), DEVICE_NAME, severity, DEVICE, FPSTR(message), networkName, eventType);
+}
+
+// Function for restarting device without losing buffered log lines
+void restartDevice() {
+    logger.flush(); // Ring buffer is in RAM, it would be lost on restart
+    ESP.restart();
 }
@@ -16,16 +16,20 @@
 #include "../event_module/event_module.h"
 #include "../api_manager/api_manager.h"
 
-// Global definitions
-#define MINIMUM_WATER_TANK_LEVEL 12.5
-
 // Declare the global instance for EventModule
 extern EventModule eventModule;
 
 // Declare the global instance for ApiManager
 extern ApiManager apiManager;
 
-// Handle an event with severity, message and event type
-extern void handleEvent(const char* severity, const char* message, const char* eventType);
+// Declare the global device identifier (MAC address) and network name (SSID), set in DeviceManager setup
+extern String deviceId;
+extern String networkName;
+
+// Handle an event with severity, message and event type, message may be in flash or in RAM
+extern void handleEvent(const char* severity, PGM_P message, const char* eventType);
+
+// Restart device after writing buffered log lines, every restart goes through this
+extern void restartDevice();
 
 #endif
@@ -0,0 +1,36 @@
+/**
+ * File: history_module.cpp
+ * Author: Joonas Nislin
+ * Date: 19.10.2026
+ * Description: This file contains implementation of HistoryModule.
+ * Provides functionality for storing history readings in one bucket document per day instead of one node per reading:
+ * history/<key>/<date><encSSID>/<deviceId>/<local midnight epoch> = {"0": "<hex>", "1740": "<hex>", ...}
+ * - Key is offset in seconds from local midnight, value is the encrypted reading
+ * - Every reading is one PATCH of its own entry, earlier entries are never written again
+ * Offsets are sparse, so the database keeps the bucket as an object instead of converting it to an array.
+ * Bucket key is derived from the reading time, so appends after reboot continue the same bucket.
+ */
+
+#include "history_module.h"
+#include "../firebase_module/firebase_module.h"
+#include "../path_builder/path_builder.h"
+#include "../time_module/time_module.h"
+#include "../transport_module/transport_module.h"
+
+// Function for appending reading to daily bucket
+bool HistoryModule::append(const PathBuilder& basePath, unsigned long epoch, const char* encryptedValue) {
+    unsigned long dayStart = getLocalDayStartEpoch(epoch);
+    char offsetKey[EPOCH_STRING_LENGTH]; // Seconds from local midnight
+    snprintf(offsetKey, sizeof(offsetKey), "%lu", epoch - dayStart);
+
+    ArenaScope arenaScope(cycleArena); // Free payload buffer on return
+    JsonWriter json(cycleArena, JSON_PAYLOAD_LIMIT); // Create JsonWriter to serialize new entry into arena buffer
+    json.set(offsetKey, encryptedValue);
+
+    PathBuilder nodePath;
+    nodePath.add(basePath.c_str()).add(dayStart);
+    if (basePath.overflowed()) {
+        return false; // Base path was cut off, entry would land in wrong bucket
+    }
+    return transport.send(json, nodePath);
+}
@@ -0,0 +1,21 @@
+/**
+ * File: history_module.h
+ * Author: Joonas Nislin
+ * Date: 19.10.2026
+ * Description: This file contains header file of HistoryModule.
+ * Holds function declarations for appending history readings into daily bucket documents.
+ */
+
+#ifndef HISTORY_MODULE_H
+#define HISTORY_MODULE_H
+
+#include <ESP8266WiFi.h>
+#include "../path_builder/path_builder.h"
+
+class HistoryModule {
+public:
+    // Append reading to daily bucket at basePath/<local midnight epoch> with one PATCH of the new entry
+    bool append(const PathBuilder& basePath, unsigned long epoch, const char* encryptedValue);
+};
+
+#endif
@@ -0,0 +1,148 @@
+/**
+ * File: json_writer.cpp
+ * Author: Joonas Nislin
+ * Date: 19.10.2026
+ * Description: This file contains implementation of JsonWriter.
+ * Provides functionality for serializing flat JSON objects without building a JSON tree.
+ * Object stays closed after every field, so the buffer can be sent at any point.
+ * Field that does not fit is rolled back whole and overflow flag is set.
+ */
+
+#include "json_writer.h"
+
+// Constructor
+JsonWriter::JsonWriter(char* buffer, size_t capacity)
+    : buffer(buffer), capacity(capacity), used(1), fields(0), overflow(false) {
+    strcpy(buffer, "{}");
+}
+
+// Constructor with arena allocated buffer
+JsonWriter::JsonWriter(Arena& arena, size_t capacity)
+    : buffer(arena.allocateChars(capacity)), capacity(capacity), used(1), fields(0), overflow(false) {
+    if (buffer == nullptr) {
+        // Nothing can be written, overflow makes sendFirebaseData refuse the payload
+        static char emptyObject[3];
+        strcpy(emptyObject, "{}");
+        buffer = emptyObject;
+        this->capacity = sizeof(emptyObject);
+        overflow = true;
+        return;
+    }
+    strcpy(buffer, "{}");
+}
+
+// Function for setting string field
+JsonWriter& JsonWriter::set(const char* key, const char* value) {
+    size_t mark = used;
+    bool fits = beginField(key) && append("\"") && appendEscaped(value) && append("\"");
+    endField(mark, fits);
+    return *this;
+}
+
+// Function for setting string field from String
+JsonWriter& JsonWriter::set(const char* key, const String& value) {
+    return set(key, value.c_str());
+}
+
+// Function for setting integer field
+JsonWriter& JsonWriter::set(const char* key, int value) {
+    char digits[12]; // Fits 32-bit value with sign
+    itoa(value, digits, 10);
+    size_t mark = used;
+    bool fits = beginField(key) && append(digits);
+    endField(mark, fits);
+    return *this;
+}
+
+// Function for setting unsigned integer field
+JsonWriter& JsonWriter::set(const char* key, unsigned long value) {
+    char digits[11]; // Fits 32-bit value
+    ultoa(value, digits, 10);
+    size_t mark = used;
+    bool fits = beginField(key) && append(digits);
+    endField(mark, fits);
+    return *this;
+}
+
+// Function for setting boolean field
+JsonWriter& JsonWriter::set(const char* key, bool value) {
+    size_t mark = used;
+    bool fits = beginField(key) && append(value ? "true" : "false");
+    endField(mark, fits);
+    return *this;
+}
+
+// Function for setting nested object field, object is already valid JSON so it is copied as is
+JsonWriter& JsonWriter::setObject(const char* key, const JsonWriter& object) {
+    size_t mark = used;
+    bool fits = !object.overflowed() && beginField(key) && append(object.c_str());
+    endField(mark, fits);
+    return *this;
+}
+
+// Function for getting serialized object
+const char* JsonWriter::c_str() const {
+    return buffer;
+}
+
+// Function for getting serialized length
+size_t JsonWriter::length() const {
+    return used + 1;
+}
+
+// Function for getting field count
+unsigned int JsonWriter::fieldCount() const {
+    return fields;
+}
+
+// Function for checking overflow
+bool JsonWriter::overflowed() const {
+    return overflow;
+}
+
+// Function for writing key and separators
+bool JsonWriter::beginField(const char* key) {
+    return (fields == 0 || append(",")) && append("\"") && appendEscaped(key) && append("\":");
+}
+
+// Function for appending raw text, one byte is always left for closing brace
+bool JsonWriter::append(const char* text) {
+    while (*text != '\0') {
+        if (used + 2 >= capacity) {
+            return false;
+        }
+        buffer[used++] = *text++;
+    }
+    return true;
+}
+
+// Function for appending escaped string contents
+bool JsonWriter::appendEscaped(const char* text) {
+    for (; *text != '\0'; text++) {
+        char c = *text;
+        char escaped[7] = {c, '\0'};
+        if (c == '"' || c == '\\') {
+            escaped[0] = '\\';
+            escaped[1] = c;
+            escaped[2] = '\0';
+        } else if ((unsigned char)c < 0x20) {
+            snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+        }
+        if (!append(escaped)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Function for closing object after field
+void JsonWriter::endField(size_t mark, bool fits) {
+    if (fits) {
+        fields++;
+    } else {
+        used = mark; // Leave the whole field out
+        overflow = true;
+    }
+    buffer[used] = '}';
+    buffer[used + 1] = '\0';
+}
@@ -0,0 +1,75 @@
+/**
+ * File: json_writer.h
+ * Author: Joonas Nislin
+ * Date: 19.10.2026
+ * Description: This file contains header file of JsonWriter.
+ * Holds declarations for writing flat JSON objects straight into a request body buffer.
+ */
+
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include <ESP8266WiFi.h>
+#include "../arena_module/arena_module.h"
+
+#define JSON_PAYLOAD_LIMIT 1024 // Fits an event with all encrypted fields and message of EVENT_MESSAGE_LIMIT
+
+class JsonWriter {
+public:
+    // Start empty object "{}" in buffer
+    JsonWriter(char* buffer, size_t capacity);
+
+    // Start empty object in buffer allocated from arena, writer is overflowed if allocation fails
+    JsonWriter(Arena& arena, size_t capacity);
+
+    // Set string field, key may contain "/" for multi-location update
+    JsonWriter& set(const char* key, const char* value);
+
+    // Set string field from String
+    JsonWriter& set(const char* key, const String& value);
+
+    // Set integer field
+    JsonWriter& set(const char* key, int value);
+
+    // Set unsigned integer field
+    JsonWriter& set(const char* key, unsigned long value);
+
+    // Set boolean field
+    JsonWriter& set(const char* key, bool value);
+
+    // Set nested object field from another writer
+    JsonWriter& setObject(const char* key, const JsonWriter& object);
+
+    // Serialized object, always valid JSON
+    const char* c_str() const;
+
+    // Serialized length in bytes
+    size_t length() const;
+
+    // Number of fields written
+    unsigned int fieldCount() const;
+
+    // True if a field did not fit and was left out
+    bool overflowed() const;
+
+private:
+    char* buffer;
+    size_t capacity;
+    size_t used; // Length without closing brace
+    unsigned int fields;
+    bool overflow;
+
+    // Write key and separators, returns false if nothing fits
+    bool beginField(const char* key);
+
+    // Append raw text
+    bool append(const char* text);
+
+    // Append text as escaped JSON string
+    bool appendEscaped(const char* text);
+
+    // Close object after field or roll back to mark if field did not fit
+    void endField(size_t mark, bool fits);
+};
+
+#endif
@@ -0,0 +1,159 @@
+/**
+ * File: local_server.cpp
+ * Author: Joonas Nislin
+ * Date: 19.10.2026
+ * Description: This file contains implementation of LocalServer.
+ * Provides functionality for reading the device straight from RAM on the local network:
+ * - http://verdantsync-<last 6 MAC digits>.local/snapshot: latest reading of every key
+ * - http://verdantsync-<last 6 MAC digits>.local/events: events waiting to be sent
+ * Readings and event severity and message are served encrypted exactly as uploaded, so the app decrypts
+ * them like firebase data. Fields uploaded in plaintext (timestamps, messageId, count) are served as is.
+ * Responses are built in the cycle arena, events are streamed one entry at a time.
+ * Uses ESP8266WebServer and ESP8266mDNS libraries.
+ */
+
+#include <ESP8266mDNS.h>
+#include "local_server.h"
+#include "../globals/globals.h"
+#include "../log_module/log_module.h"
+
+#define LOG_TAG "local"
+
+LocalServer localServer;
+
+// Function for starting server and mDNS responder
+void LocalServer::begin(const String& deviceId) {
+    // Hostname from last three MAC bytes, "AA:BB:CC:DD:EE:FF" gives "verdantsync-ddeeff"
+    char hostname[24] = "verdantsync-";
+    size_t length = strlen(hostname);
+    for (unsigned int i = deviceId.length() > 8 ? deviceId.length() - 8 : 0; i < deviceId.length() && length < sizeof(hostname) - 1; i++) {
+        char c = deviceId[i];
+        if (c != ':') {
+            hostname[length++] = tolower(c);
+        }
+    }
+    hostname[length] = '\0';
+
+    server.on("/snapshot", HTTP_GET, [this]() { handleSnapshot(); });
+    server.on("/events", HTTP_GET, [this]() { handleEvents(); });
+    server.begin();
+    if (MDNS.begin(hostname)) {
+        MDNS.addService("http", "tcp", 80);
+    }
+    started = true;
+
+    LOG_INFO("Serving http://%s.local/snapshot", hostname);
+}
+
+// Function for serving pending requests
+void LocalServer::loop() {
+    if (!started) {
+        return;
+    }
+    unsigned long startMicros = micros();
+    server.handleClient();
+    MDNS.update();
+    unsigned long elapsed = micros() - startMicros;
+    if (elapsed > maxLoopMicros) {
+        maxLoopMicros = elapsed;
+    }
+}
+
+// Function for storing latest reading of key
+void LocalServer::updateReading(const char* key, const char* encryptedValue, unsigned long epoch) {
+    if (strlen(key) >= sizeof(snapshot[0].key) || strlen(encryptedValue) >= sizeof(snapshot[0].value)) {
+        return;
+    }
+
+    SnapshotEntry* entry = nullptr;
+    for (int i = 0; i < numEntries; i++) {
+        if (strcmp(snapshot[i].key, key) == 0) {
+            entry = &snapshot[i];
+            break;
+        }
+    }
+    if (entry == nullptr) {
+        if (numEntries >= LOCAL_SNAPSHOT_SIZE) {
+            return;
+        }
+        entry = &snapshot[numEntries++];
+        strcpy(entry->key, key);
+    }
+    strcpy(entry->value, encryptedValue);
+    entry->epoch = epoch;
+}
+
+// Function for printing request statistics
+void LocalServer::printStats() const {
+    LOG_INFO("%lu requests, longest loop %lu us", requests, maxLoopMicros);
+}
+
+// Function for sending latest readings
+void LocalServer::handleSnapshot() {
+    ArenaScope arenaScope(cycleArena); // Free response buffers on return
+    JsonWriter json(cycleArena, LOCAL_RESPONSE_LIMIT);
+    for (int i = 0; i < numEntries; i++) {
+        char entryBuffer[96];
+        JsonWriter entry(entryBuffer, sizeof(entryBuffer));
+        entry.set("v", snapshot[i].value);
+        entry.set("t", snapshot[i].epoch);
+        json.setObject(snapshot[i].key, entry);
+    }
+    sendJson(json);
+}
+
+// Function for streaming queued events, entries that do not fit are counted in "skipped"
+void LocalServer::handleEvents() {
+    requests++;
+    server.setContentLength(CONTENT_LENGTH_UNKNOWN); // Queue does not fit one buffer, send entry by entry
+    server.send(200, "application/json", "");
+    server.sendContent("{");
+
+    unsigned long skipped = 0;
+    for (int slot = 0; slot < MAX_EVENTS; slot++) {
+        const Event* event = eventModule.getQueuedEvent(slot);
+        if (event == nullptr) {
+            continue;
+        }
+        ArenaScope arenaScope(cycleArena); // Free entry buffers before next entry
+        char* encryptedSeverity = cycleArena.allocateChars(INPUT_BUFFER_LIMIT + ENCRYPTED_MESSAGE_LENGTH);
+        JsonWriter entry(cycleArena, LOCAL_EVENT_LIMIT);
+        if (encryptedSeverity == nullptr || entry.overflowed() || event->message.length() > EVENT_MESSAGE_LIMIT) {
+            skipped++;
+            continue;
+        }
+        char* encryptedMessage = encryptedSeverity + INPUT_BUFFER_LIMIT;
+        eventModule.encryptSeverityAndMessage(*event, encryptedSeverity, encryptedMessage);
+
+        entry.set("severity", encryptedSeverity);
+        entry.set("message", encryptedMessage);
+        entry.set("messageId", event->messageId);
+        entry.set("timestamp", event->timestamp);
+        entry.set("lastTimestamp", event->lastTimestamp);
+        entry.set("count", (unsigned long)event->count);
+        if (entry.overflowed()) {
+            skipped++; // Never serve an entry with fields left out
+            continue;
+        }
+
+        char key[8];
+        snprintf(key, sizeof(key), "\"%d\":", slot);
+        server.sendContent(key);
+        server.sendContent(entry.c_str());
+        server.sendContent(",");
+    }
+
+    char tail[32];
+    snprintf(tail, sizeof(tail), "\"skipped\":%lu}", skipped);
+    server.sendContent(tail);
+    server.sendContent(""); // End chunked response
+    if (skipped > 0) {
+        LOG_WARNING("Local events response skipped %lu entries.", skipped);
+    }
+}
+
+// Function for sending JSON response
+void LocalServer::sendJson(const JsonWriter& json) {
+    requests++;
+    server.send(200, "application/json", json.c_str()); // Entries that did not fit are left out
+}
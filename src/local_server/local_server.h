@@ -0,0 +1,64 @@
+/**
+ * File: local_server.h
+ * Author: Joonas Nislin
+ * Date: 19.10.2026
+ * Description: This file contains header file of LocalServer.
+ * Holds function declarations and constants for serving latest readings and event queue on local network.
+ */
+
+#ifndef LOCAL_SERVER_H
+#define LOCAL_SERVER_H
+
+#include <ESP8266WiFi.h>
+#include <ESP8266WebServer.h>
+#include "../aes_module/aes_module.h"
+#include "../json_writer/json_writer.h"
+
+#define LOCAL_SNAPSHOT_SIZE 12 // One entry per uploaded key
+#define LOCAL_VALUE_LENGTH (2 * N_BLOCK) // Hex length of one encrypted reading
+#define LOCAL_RESPONSE_LIMIT 2048 // Fits full snapshot
+#define LOCAL_EVENT_LIMIT 640 // Fits one event entry with encrypted message of EVENT_MESSAGE_LIMIT
+
+// Structure to represent latest encrypted reading of one key
+struct SnapshotEntry {
+    char key[32]; // Node path key, for example "temperature"
+    char value[LOCAL_VALUE_LENGTH + 1]; // Encrypted reading, same as uploaded to firebase
+    unsigned long epoch; // Time of reading
+};
+
+class LocalServer {
+public:
+    // Start HTTP server and advertise it with mDNS
+    void begin(const String& deviceId);
+
+    // Serve pending requests, called on every loop
+    void loop();
+
+    // Store latest reading of key
+    void updateReading(const char* key, const char* encryptedValue, unsigned long epoch);
+
+    // Print request count and worst loop time spent serving
+    void printStats() const;
+
+private:
+    ESP8266WebServer server{80};
+    SnapshotEntry snapshot[LOCAL_SNAPSHOT_SIZE];
+    int numEntries = 0;
+    bool started = false;
+    unsigned long requests = 0;
+    unsigned long maxLoopMicros = 0; // Longest handleClient call since boot
+
+    // Send latest readings as {"<key>": {"v": "<hex>", "t": <epoch>}, ...}
+    void handleSnapshot();
+
+    // Send event queue as {"<slot>": {"severity": <hex>, "message": <hex>, ...}, ..., "skipped": <count>}
+    void handleEvents();
+
+    // Send JSON response
+    void sendJson(const JsonWriter& json);
+};
+
+// Local server shared by DeviceManager and ApiManager
+extern LocalServer localServer;
+
+#endif
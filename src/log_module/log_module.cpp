@@ -0,0 +1,130 @@
+/**
+ * File: log_module.cpp
+ * Author: Joonas Nislin
+ * Date: 19.10.2026
+ * Description: This file contains implementation of LogModule.
+ * Provides functionality for logging without blocking the loop:
+ * - Lines are formatted as "<millis> <level> <tag>: <message>" into a RAM ring buffer
+ * - loop() writes only as many bytes as the UART FIFO has room for
+ * - A line that does not fit the ring buffer is dropped whole and counted
+ * - Buffer is written out before restart and from crash callback on exception and software watchdog resets
+ */
+
+#include "log_module.h"
+
+#define LOG_TAG "log"
+
+LogModule logger;
+
+// Level letters, index is log level
+const char LOG_LEVEL_LETTERS[] = "-EWID";
+
+// Function for formatting line and storing it in ring buffer
+void LogModule::write(uint8_t level, PGM_P tag, PGM_P format, ...) {
+    char line[LOG_LINE_LENGTH];
+    int length = snprintf(line, sizeof(line), "%lu %c ", millis(), LOG_LEVEL_LETTERS[level]);
+
+    // Tag is in flash, copy it with flash reads
+    size_t tagLength = strlen_P(tag);
+    if (tagLength > sizeof(line) - length - 3) {
+        tagLength = sizeof(line) - length - 3;
+    }
+    memcpy_P(line + length, tag, tagLength);
+    length += tagLength;
+    line[length++] = ':';
+    line[length++] = ' ';
+
+    va_list arguments;
+    va_start(arguments, format);
+    int messageLength = vsnprintf_P(line + length, sizeof(line) - length - 1, format, arguments);
+    va_end(arguments);
+    if (messageLength > 0) {
+        length += messageLength < (int)(sizeof(line) - length - 1) ? messageLength : (int)(sizeof(line) - length - 2);
+    }
+    line[length++] = '\n';
+
+    if (push(line, length)) {
+        stats.written++;
+    } else {
+        stats.dropped++;
+    }
+    loop(); // Start sending right away if UART has room
+}
+
+// Function for copying line into ring buffer
+bool LogModule::push(const char* line, size_t length) {
+    if (length > LOG_BUFFER_SIZE - used) {
+        return false;
+    }
+    for (size_t i = 0; i < length; i++) {
+        buffer[head] = line[i];
+        head = (head + 1) % LOG_BUFFER_SIZE;
+    }
+    used += length;
+    if (used > stats.maxUsed) {
+        stats.maxUsed = used;
+    }
+    return true;
+}
+
+// Function for moving buffered bytes to UART without waiting
+void LogModule::loop() {
+    while (used > 0) {
+        size_t room = Serial.availableForWrite();
+        if (room == 0) {
+            return; // FIFO is full, rest is sent on next call
+        }
+        size_t chunk = LOG_BUFFER_SIZE - tail; // Bytes until buffer wraps
+        if (chunk > used) {
+            chunk = used;
+        }
+        if (chunk > room) {
+            chunk = room;
+        }
+        Serial.write((const uint8_t*)buffer + tail, chunk);
+        tail = (tail + chunk) % LOG_BUFFER_SIZE;
+        used -= chunk;
+    }
+}
+
+// Function for writing every buffered byte
+void LogModule::flush() {
+    while (used > 0) {
+        loop();
+        yield();
+    }
+    Serial.flush();
+}
+
+// Function for writing every buffered byte from crash handler
+void LogModule::flushFromCrash() {
+    while (used > 0) {
+        size_t chunk = LOG_BUFFER_SIZE - tail; // Bytes until buffer wraps
+        if (chunk > used) {
+            chunk = used;
+        }
+        Serial.write((const uint8_t*)buffer + tail, chunk); // Waits for FIFO room without yield
+        tail = (tail + chunk) % LOG_BUFFER_SIZE;
+        used -= chunk;
+    }
+    Serial.flush();
+}
+
+// Function for getting counters
+const LogStats& LogModule::getStats() const {
+    return stats;
+}
+
+// Function for logging counters
+void LogModule::printStats() {
+    LOG_INFO("%lu lines, %lu dropped, %u of %u buffer bytes used at most",
+             stats.written, stats.dropped, (unsigned int)stats.maxUsed, (unsigned int)LOG_BUFFER_SIZE);
+}
+
+// Function called by ESP8266 core before crash dump on exception and software watchdog reset
+extern "C" void custom_crash_callback(struct rst_info* resetInfo, uint32_t stack, uint32_t stackEnd) {
+    (void)resetInfo;
+    (void)stack;
+    (void)stackEnd;
+    logger.flushFromCrash(); // Lines logged just before crash are the most useful ones
+}
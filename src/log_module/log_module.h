@@ -0,0 +1,95 @@
+/**
+ * File: log_module.h
+ * Author: Joonas Nislin
+ * Date: 19.10.2026
+ * Description: This file contains header file of LogModule.
+ * Holds declarations and macros for leveled logging through a RAM ring buffer.
+ * Levels above LOG_LEVEL in config.h are compiled out. Each .cpp file defines LOG_TAG before using the macros.
+ */
+
+#ifndef LOG_MODULE_H
+#define LOG_MODULE_H
+
+#include <ESP8266WiFi.h>
+
+#define LOG_LEVEL_NONE 0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARNING 2
+#define LOG_LEVEL_INFO 3
+#define LOG_LEVEL_DEBUG 4
+
+#include "../../config/config.h"
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+#define LOG_BUFFER_SIZE 1024 // Bytes of ring buffer waiting for UART
+#define LOG_LINE_LENGTH 192 // Longer lines are cut, a COST line fits
+
+// Format string and tag are kept in flash, arguments are formatted like printf
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(format, ...) logger.write(LOG_LEVEL_ERROR, PSTR(LOG_TAG), PSTR(format), ##__VA_ARGS__)
+#else
+#define LOG_ERROR(format, ...) do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_WARNING
+#define LOG_WARNING(format, ...) logger.write(LOG_LEVEL_WARNING, PSTR(LOG_TAG), PSTR(format), ##__VA_ARGS__)
+#else
+#define LOG_WARNING(format, ...) do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(format, ...) logger.write(LOG_LEVEL_INFO, PSTR(LOG_TAG), PSTR(format), ##__VA_ARGS__)
+#else
+#define LOG_INFO(format, ...) do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(format, ...) logger.write(LOG_LEVEL_DEBUG, PSTR(LOG_TAG), PSTR(format), ##__VA_ARGS__)
+#else
+#define LOG_DEBUG(format, ...) do {} while (0)
+#endif
+
+// Structure to represent logger counters for diagnostics
+struct LogStats {
+    unsigned long written; // Lines stored in ring buffer
+    unsigned long dropped; // Lines lost because ring buffer was full
+    size_t maxUsed; // Most bytes waiting for UART at once
+};
+
+class LogModule {
+public:
+    // Format line and store it in ring buffer, never waits for UART
+    void write(uint8_t level, PGM_P tag, PGM_P format, ...);
+
+    // Move buffered bytes to UART as far as its FIFO has room
+    void loop();
+
+    // Wait until every buffered byte is written, used before restart
+    void flush();
+
+    // Write every buffered byte without yielding, used from crash handler where scheduler is stopped
+    void flushFromCrash();
+
+    // Get counters
+    const LogStats& getStats() const;
+
+    // Print counters as a log line
+    void printStats();
+
+private:
+    char buffer[LOG_BUFFER_SIZE];
+    size_t head = 0; // Next byte written
+    size_t tail = 0; // Next byte sent to UART
+    size_t used = 0;
+    LogStats stats = {0, 0, 0};
+
+    // Copy line into ring buffer, returns false if it does not fit
+    bool push(const char* line, size_t length);
+};
+
+extern LogModule logger;
+
+#endif
@@ -0,0 +1,140 @@
+/**
+ * File: mux_module.cpp
+ * Author: Joonas Nislin
+ * Date: 19.10.2026
+ * Description: This file contains implementation of MuxModule.
+ * Provides functionality for reading analog sensors through CD74HC4051E multiplexer.
+ * Channels are scanned in gray code order so that only one select pin toggles between reads,
+ * and settle delay is only spent when the selected channel actually changes.
+ */
+
+#include "mux_module.h"
+#include "../log_module/log_module.h"
+
+#define LOG_TAG "mux"
+
+// Constructor
+MuxModule::MuxModule(int selectPin1, int selectPin2, int selectPin3, int analogPin)
+    : selectPins{selectPin1, selectPin2, selectPin3}, analogPin(analogPin) {}
+
+// Setup function
+void MuxModule::setup() {
+    for (int i = 0; i < 3; i++) {
+        if (selectPins[i] != MUX_PIN_GROUNDED) {
+            pinMode(selectPins[i], OUTPUT);
+        }
+    }
+    currentChannel = -1; // Pin states are unknown until first selection
+}
+
+// Function for checking if channel can be selected with the wired select pins
+bool MuxModule::isChannelReachable(uint8_t channel) const {
+    if (channel >= MUX_MAX_CHANNELS) {
+        return false;
+    }
+    for (int i = 0; i < 3; i++) {
+        // Grounded select pin can only select channels where its bit is LOW
+        if (selectPins[i] == MUX_PIN_GROUNDED && (channel & (1 << i))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Function for driving select pins, only toggles the pins that differ from current selection
+bool MuxModule::selectChannel(uint8_t channel) {
+    if (currentChannel == channel) {
+        return false; // Already selected, no switching needed
+    }
+    for (int i = 0; i < 3; i++) {
+        if (selectPins[i] == MUX_PIN_GROUNDED) {
+            continue;
+        }
+        bool level = channel & (1 << i);
+        if (currentChannel < 0 || level != (bool)(currentChannel & (1 << i))) {
+            digitalWrite(selectPins[i], level ? HIGH : LOW);
+        }
+    }
+    currentChannel = channel;
+    return true;
+}
+
+// Function for reading one channel
+int MuxModule::readChannel(const MuxChannel& channel) {
+    if (!isChannelReachable(channel.channel)) {
+        LOG_WARNING("Multiplexer channel not reachable: %u", (unsigned int)channel.channel);
+        return -1;
+    }
+
+    // Let the input settle only if the selection changed
+    if (selectChannel(channel.channel)) {
+        delay(channel.settleTimeMs);
+    }
+
+    int raw = analogRead(analogPin); // Read the analog value from sensor
+
+    // Map raw value with per-channel calibration to common 0-1023 scale
+    if (channel.calibrationRawMin == 0 && channel.calibrationRawMax == 1023) {
+        return raw;
+    }
+    int calibrated = map(raw, channel.calibrationRawMin, channel.calibrationRawMax, 0, 1023);
+    return constrain(calibrated, 0, 1023);
+}
+
+// Function for scanning channels in gray code order
+void MuxModule::scan(const MuxChannel* channels, int count, int* results) {
+    unsigned long scanStartMicros = micros();
+    int order[MUX_MAX_CHANNELS];
+    int orderCount = count < MUX_MAX_CHANNELS ? count : MUX_MAX_CHANNELS;
+
+    // Sort channel indexes by gray code rank (insertion sort, at most 8 entries)
+    for (int i = 0; i < orderCount; i++) {
+        int j = i;
+        while (j > 0 && grayCodeRank(channels[order[j - 1]].channel) > grayCodeRank(channels[i].channel)) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = i;
+    }
+
+    // Rotate sequence so that it starts from currently selected channel when possible
+    int start = 0;
+    for (int i = 0; i < orderCount; i++) {
+        if (channels[order[i]].channel == currentChannel) {
+            start = i;
+            break;
+        }
+    }
+
+    for (int i = 0; i < orderCount; i++) {
+        int index = order[(start + i) % orderCount];
+        results[index] = readChannel(channels[index]);
+    }
+
+    // Channels above multiplexer size cannot be read
+    for (int i = orderCount; i < count; i++) {
+        results[i] = -1;
+    }
+
+    lastScanMicros = micros() - scanStartMicros;
+    lastScanChannelCount = orderCount;
+}
+
+// Function for getting duration of latest scan
+unsigned long MuxModule::getLastScanMicros() const {
+    return lastScanMicros;
+}
+
+// Function for getting channel count of latest scan
+int MuxModule::getLastScanChannelCount() const {
+    return lastScanChannelCount;
+}
+
+// Function for getting position of channel in gray code sequence (0,1,3,2,6,7,5,4)
+uint8_t MuxModule::grayCodeRank(uint8_t channel) {
+    uint8_t rank = channel;
+    for (uint8_t shift = channel >> 1; shift; shift >>= 1) {
+        rank ^= shift;
+    }
+    return rank;
+}
@@ -0,0 +1,62 @@
+/**
+ * File: mux_module.h
+ * Author: Joonas Nislin
+ * Date: 19.10.2026
+ * Description: This file contains header file of MuxModule.
+ * Holds function declarations and constants for CD74HC4051E multiplexer channel scanning.
+ */
+
+#ifndef MUX_MODULE_H
+#define MUX_MODULE_H
+
+#include <ESP8266WiFi.h>
+
+#define MUX_MAX_CHANNELS 8 // CD74HC4051E has 8 analog inputs
+#define MUX_PIN_GROUNDED -1 // Select pin that is tied to ground instead of a GPIO
+
+// Structure to represent one analog input wired to the multiplexer
+struct MuxChannel {
+    uint8_t channel; // Multiplexer input (0-7)
+    unsigned int settleTimeMs; // Delay after switching to this channel before reading
+    int calibrationRawMin; // Raw reading mapped to 0
+    int calibrationRawMax; // Raw reading mapped to 1023
+};
+
+class MuxModule {
+public:
+    // Set select pins, pin value MUX_PIN_GROUNDED means the select line is tied to ground
+    MuxModule(int selectPin1, int selectPin2, int selectPin3, int analogPin);
+
+    // Setup function
+    void setup();
+
+    // Select channel, wait for it to settle and return calibrated reading (-1 if channel is unreachable)
+    int readChannel(const MuxChannel& channel);
+
+    // Read all channels in switching-optimal order, results are stored in the order of channels
+    void scan(const MuxChannel* channels, int count, int* results);
+
+    // Duration of the latest scan in microseconds
+    unsigned long getLastScanMicros() const;
+
+    // Number of channels read in the latest scan
+    int getLastScanChannelCount() const;
+
+private:
+    int selectPins[3]; // S0, S1, S2
+    int analogPin;
+    int currentChannel = -1; // Currently selected channel, -1 if not known
+    unsigned long lastScanMicros = 0;
+    int lastScanChannelCount = 0;
+
+    // Check if channel can be selected with the wired select pins
+    bool isChannelReachable(uint8_t channel) const;
+
+    // Drive select pins for channel, returns true if the selection changed
+    bool selectChannel(uint8_t channel);
+
+    // Position of channel in gray code sequence, neighbouring positions differ by one select pin
+    static uint8_t grayCodeRank(uint8_t channel);
+};
+
+#endif
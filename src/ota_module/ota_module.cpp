@@ -0,0 +1,251 @@
+/**
+ * File: ota_module.cpp
+ * Author: Joonas Nislin
+ * Date: 19.10.2026
+ * Description: This file contains implementation of OtaModule.
+ * Provides functionality for updating firmware from firmware/manifest node:
+ * - Manifest fields: version, url, size and optional md5
+ * - Only a version newer than FIRMWARE_VERSION is installed, versions are compared as dotted numbers
+ * - One TLS client with reduced buffers is kept for the whole update, range requests reuse its connection
+ * - Image is downloaded with HTTP range requests, a failed chunk is resumed from the last written byte
+ * - Image is signed with the core signing tool and gzip compressed, Updater verifies the signature
+ *   against OTA_SIGNING_PUBLIC_KEY and eboot decompresses and swaps it in on restart
+ * - State and progress are written to devices/<deviceId>/ota
+ * Uses ESP8266HTTPClient and Updater of ESP8266 core.
+ */
+
+#include <ESP8266HTTPClient.h>
+#include <Updater.h>
+#include "ota_module.h"
+#include "../../config/config.h"
+#include "../globals/globals.h"
+#include "../path_builder/path_builder.h"
+#include "../watchdog_module/watchdog_module.h"
+#include "../log_module/log_module.h"
+
+#define LOG_TAG "ota"
+
+// Signature verification of downloaded images
+BearSSL::PublicKey otaSigningKey(OTA_SIGNING_PUBLIC_KEY);
+BearSSL::HashSHA256 otaHash;
+BearSSL::SigningVerifier otaVerifier(&otaSigningKey);
+
+// Function for checking manifest and staging newer firmware
+bool OtaModule::checkAndUpdate(const String& deviceId) {
+    WatchdogScope watchdogScope(STAGE_OTA);
+    this->deviceId = deviceId;
+
+    OtaManifest manifest;
+    if (!readManifest(manifest)) {
+        return false; // No manifest available
+    }
+    if (manifest.url.length() == 0 || manifest.size == 0) {
+        return false; // Manifest is incomplete
+    }
+    if (compareVersions(manifest.version.c_str(), FIRMWARE_VERSION) <= 0) {
+        return false; // Already up to date, older images are never installed
+    }
+
+    LOG_INFO("Firmware update available: %s", manifest.version.c_str());
+    targetVersion = manifest.version;
+
+    if (!downloadAndStage(manifest)) {
+        reportProgress("failed", 0);
+        return false;
+    }
+    reportProgress("staged", 100);
+    return true;
+}
+
+// Function for reading manifest from firebase
+bool OtaModule::readManifest(OtaManifest& manifest) {
+    if (!Firebase.getJSON(firebaseData, "firmware/manifest")) {
+        return false;
+    }
+
+    FirebaseJson& json = firebaseData.jsonObject();
+    FirebaseJsonData data;
+    manifest.version = json.get(data, "version") && data.success ? data.stringValue : String("");
+    manifest.url = json.get(data, "url") && data.success ? data.stringValue : String("");
+    manifest.size = json.get(data, "size") && data.success ? (unsigned long)data.intValue : 0;
+    manifest.md5 = json.get(data, "md5") && data.success ? data.stringValue : String("");
+    return true;
+}
+
+// Function for downloading image into update partition
+bool OtaModule::downloadAndStage(const OtaManifest& manifest) {
+    unsigned long startMillis = millis();
+
+    if (strlen_P(OTA_SIGNING_PUBLIC_KEY) == 0) {
+        LOG_ERROR("OTA signing key not configured, update refused");
+        return false; // Unsigned images are never installed
+    }
+    if (manifest.size > ESP.getFreeSketchSpace()) {
+        LOG_ERROR("Firmware image does not fit free sketch space");
+        return false;
+    }
+
+    Update.installSignature(&otaHash, &otaVerifier); // Image is rejected in end() if signature does not match
+    if (!Update.begin(manifest.size)) {
+        LOG_ERROR("Update begin failed: %s", Update.getErrorString().c_str());
+        return false;
+    }
+    if (manifest.md5.length() > 0) {
+        Update.setMD5(manifest.md5.c_str());
+    }
+
+    // One client for all range requests, connection is kept alive between them
+    BearSSL::WiFiClientSecure client;
+    configureClient(client, manifest.url.c_str());
+    HTTPClient http;
+    http.setReuse(true);
+
+    int lastReportedPercent = -1;
+    int retries = 0;
+    while (Update.progress() < manifest.size) {
+        // Resume from the last byte written, also after a chunk that broke off midway
+        size_t offset = Update.progress();
+        size_t length = manifest.size - offset < CHUNK_SIZE ? manifest.size - offset : CHUNK_SIZE;
+
+        if (downloadChunk(http, client, manifest.url.c_str(), offset, length) == 0) {
+            if (++retries > MAX_CHUNK_RETRIES) {
+                LOG_ERROR("Firmware download failed");
+                http.end();
+                Update.end(false);
+                return false;
+            }
+            continue;
+        }
+        retries = 0;
+
+        int percent = (int)((uint64_t)Update.progress() * 100 / manifest.size);
+        if (percent / 10 != lastReportedPercent / 10) {
+            reportProgress("downloading", percent);
+            lastReportedPercent = percent;
+        }
+    }
+
+    http.end();
+    client.stop(); // Release TLS buffers before signature verification
+
+    // Verifies signature and MD5, then marks image to be copied over the running one on restart
+    if (!Update.end()) {
+        LOG_ERROR("Image rejected: %s", Update.getErrorString().c_str());
+        return false;
+    }
+
+    // Print transfer size and time so compressed and raw images can be compared
+    LOG_INFO("Firmware staged: %lu bytes in %lu ms", manifest.size, millis() - startMillis);
+    return true;
+}
+
+// Function for setting TLS buffers of update client
+void OtaModule::configureClient(BearSSL::WiFiClientSecure& client, const char* url) {
+    client.setInsecure(); // Image authenticity comes from signature, not from TLS certificate
+
+    // Host and port from "https://host[:port]/path"
+    const char* host = strstr(url, "://");
+    host = host != nullptr ? host + 3 : url;
+    size_t hostLength = strcspn(host, ":/");
+    char hostname[64];
+    if (hostLength >= sizeof(hostname)) {
+        hostLength = sizeof(hostname) - 1;
+    }
+    memcpy(hostname, host, hostLength);
+    hostname[hostLength] = '\0';
+    uint16_t port = host[hostLength] == ':' ? (uint16_t)atoi(host + hostLength + 1) : HTTPS_PORT;
+
+    // Server that does not negotiate smaller records needs a receive buffer for a full record
+    bool smallRecords = BearSSL::WiFiClientSecure::probeMaxFragmentLength(hostname, port, TLS_FRAGMENT_LENGTH);
+    client.setBufferSizes(smallRecords ? TLS_FRAGMENT_LENGTH : TLS_RECORD_LENGTH, TLS_TX_BUFFER);
+    LOG_INFO("Update client: %u byte TLS records", (unsigned int)(smallRecords ? TLS_FRAGMENT_LENGTH : TLS_RECORD_LENGTH));
+}
+
+// Function for downloading one byte range into update partition
+size_t OtaModule::downloadChunk(HTTPClient& http, BearSSL::WiFiClientSecure& client, const char* url, size_t offset, size_t length) {
+    if (!http.begin(client, url)) { // Reuses open connection of previous chunk
+        return 0;
+    }
+
+    char range[32];
+    snprintf(range, sizeof(range), "bytes=%u-%u", (unsigned int)offset, (unsigned int)(offset + length - 1));
+    http.addHeader("Range", range);
+    http.setTimeout(CHUNK_TIMEOUT);
+
+    int httpCode = http.GET();
+    if (httpCode != HTTP_CODE_PARTIAL_CONTENT) {
+        http.end();
+        return 0; // Server must support range requests
+    }
+
+    WiFiClient* stream = http.getStreamPtr();
+    uint8_t buffer[512];
+    size_t written = 0;
+    unsigned long lastDataMillis = millis();
+    while (written < length && millis() - lastDataMillis < CHUNK_TIMEOUT) {
+        size_t available = stream->available();
+        if (available == 0) {
+            delay(1);
+            continue;
+        }
+        size_t toRead = length - written;
+        if (toRead > sizeof(buffer)) {
+            toRead = sizeof(buffer);
+        }
+        if (toRead > available) {
+            toRead = available;
+        }
+        size_t received = stream->readBytes(buffer, toRead);
+        if (Update.write(buffer, received) != received) {
+            break; // Flash write failed
+        }
+        written += received;
+        lastDataMillis = millis();
+    }
+    if (written < length) {
+        client.stop(); // Rest of broken chunk may still arrive, next chunk starts on a new connection
+    }
+    http.end(); // Keeps connection open for next chunk when server allows it
+    return written;
+}
+
+// Function for reporting update state and progress
+void OtaModule::reportProgress(const char* state, int percent) {
+    LOG_INFO("Firmware update %s: %d %%", state, percent);
+
+    ArenaScope arenaScope(cycleArena); // Free payload buffer on return
+    JsonWriter json(cycleArena, JSON_PAYLOAD_LIMIT); // Create JsonWriter to serialize payload into arena buffer
+    json.set("state", state);
+    json.set("progress", percent);
+    json.set("running", FIRMWARE_VERSION);
+    json.set("target", targetVersion);
+
+    PathBuilder nodePath;
+    nodePath.add("devices/").add(deviceId).add("/ota");
+    sendFirebaseData(json, nodePath);
+}
+
+// Function for comparing dotted numeric versions
+int OtaModule::compareVersions(const char* a, const char* b) {
+    // Leading non-digits such as "v" are skipped, missing parts count as zero, e.g. "1.2" equals "1.2.0"
+    while (*a != '\0' && !isdigit((unsigned char)*a)) {
+        a++;
+    }
+    while (*b != '\0' && !isdigit((unsigned char)*b)) {
+        b++;
+    }
+    while (*a != '\0' || *b != '\0') {
+        char* end;
+        unsigned long partA = strtoul(a, &end, 10);
+        a = end;
+        unsigned long partB = strtoul(b, &end, 10);
+        b = end;
+        if (partA != partB) {
+            return partA < partB ? -1 : 1;
+        }
+        // Continue only over dot separated numbers, any other suffix ends comparison
+        a = *a == '.' ? a + 1 : (*a != '\0' && !isdigit((unsigned char)*a) ? "" : a);
+        b = *b == '.' ? b + 1 : (*b != '\0' && !isdigit((unsigned char)*b) ? "" : b);
+    }
+    return 0;
+}
@@ -0,0 +1,60 @@
+/**
+ * File: ota_module.h
+ * Author: Joonas Nislin
+ * Date: 19.10.2026
+ * Description: This file contains header file of OtaModule.
+ * Holds function declarations and constants for over-the-air firmware updates.
+ */
+
+#ifndef OTA_MODULE_H
+#define OTA_MODULE_H
+
+#include <ESP8266WiFi.h>
+#include <ESP8266HTTPClient.h>
+
+// Structure to represent firmware manifest stored in firmware/manifest node
+struct OtaManifest {
+    String version; // Dotted numeric firmware version, only a version newer than FIRMWARE_VERSION is installed
+    String url; // HTTPS URL of signed and gzip compressed image
+    unsigned long size; // Image size in bytes as downloaded
+    String md5; // Optional MD5 of downloaded image
+};
+
+class OtaModule {
+public:
+    // Check manifest and stage newer firmware, returns true if device should restart to swap images
+    bool checkAndUpdate(const String& deviceId);
+
+private:
+    String deviceId;
+    String targetVersion; // Version being downloaded
+
+    // Read manifest from firebase
+    bool readManifest(OtaManifest& manifest);
+
+    // Download image in chunks into update partition and verify it
+    bool downloadAndStage(const OtaManifest& manifest);
+
+    // Download one byte range over connection kept for the whole update, returns number of bytes written
+    size_t downloadChunk(HTTPClient& http, BearSSL::WiFiClientSecure& client, const char* url, size_t offset, size_t length);
+
+    // Set TLS buffers of update client, small records are used when server supports them
+    void configureClient(BearSSL::WiFiClientSecure& client, const char* url);
+
+    // Compare dotted numeric versions, e.g. "1.2.10" > "1.2.9", returns negative, zero or positive like strcmp
+    static int compareVersions(const char* a, const char* b);
+
+    // Write update state and progress to devices/<deviceId>/ota
+    void reportProgress(const char* state, int percent);
+
+    // Constants and Configuration Settings
+    const size_t CHUNK_SIZE = 16384; // Bytes per range request
+    const int MAX_CHUNK_RETRIES = 3; // Attempts per chunk before update is aborted
+    const unsigned long CHUNK_TIMEOUT = 15000; // Milliseconds to wait for chunk data
+    const uint16_t TLS_FRAGMENT_LENGTH = 1024; // Record size asked from server with max fragment length extension
+    const uint16_t TLS_RECORD_LENGTH = 16384; // Full record, receive buffer when server does not negotiate smaller
+    const uint16_t TLS_TX_BUFFER = 512; // Only request headers are sent
+    const uint16_t HTTPS_PORT = 443;
+};
+
+#endif
@@ -0,0 +1,63 @@
+/**
+ * File: path_builder.cpp
+ * Author: Joonas Nislin
+ * Date: 19.10.2026
+ * Description: This file contains implementation of PathBuilder.
+ * Provides functionality for building node paths without heap allocations.
+ * Text that does not fit is cut off and overflow flag is set.
+ */
+
+#include "path_builder.h"
+
+// Constructor
+PathBuilder::PathBuilder() : used(0), overflow(false) {
+    buffer[0] = '\0';
+}
+
+// Function for appending text
+PathBuilder& PathBuilder::add(const char* text) {
+    while (*text != '\0') {
+        if (used + 1 >= PATH_BUILDER_CAPACITY) {
+            overflow = true;
+            break;
+        }
+        buffer[used++] = *text++;
+    }
+    buffer[used] = '\0';
+    return *this;
+}
+
+// Function for appending String contents
+PathBuilder& PathBuilder::add(const String& text) {
+    return add(text.c_str());
+}
+
+// Function for appending number
+PathBuilder& PathBuilder::add(unsigned long value) {
+    char digits[11]; // Fits 32-bit value
+    ultoa(value, digits, 10);
+    return add(digits);
+}
+
+// Function for shortening path
+void PathBuilder::truncate(size_t length) {
+    if (length < used) {
+        used = length;
+        buffer[used] = '\0';
+    }
+}
+
+// Function for getting path
+const char* PathBuilder::c_str() const {
+    return buffer;
+}
+
+// Function for getting path length
+size_t PathBuilder::length() const {
+    return used;
+}
+
+// Function for checking overflow
+bool PathBuilder::overflowed() const {
+    return overflow;
+}
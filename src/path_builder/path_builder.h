@@ -0,0 +1,48 @@
+/**
+ * File: path_builder.h
+ * Author: Joonas Nislin
+ * Date: 19.10.2026
+ * Description: This file contains header file of PathBuilder.
+ * Holds declarations for building node paths and keys in a fixed-size stack buffer.
+ */
+
+#ifndef PATH_BUILDER_H
+#define PATH_BUILDER_H
+
+#include <ESP8266WiFi.h>
+
+#define PATH_BUILDER_CAPACITY 192 // Fits history path with encrypted 32 character SSID
+
+class PathBuilder {
+public:
+    // Constructor, starts with empty path
+    PathBuilder();
+
+    // Append text to path
+    PathBuilder& add(const char* text);
+
+    // Append String contents to path
+    PathBuilder& add(const String& text);
+
+    // Append number to path
+    PathBuilder& add(unsigned long value);
+
+    // Shorten path back to given length, used to reuse a common prefix
+    void truncate(size_t length);
+
+    // Null terminated path
+    const char* c_str() const;
+
+    // Current path length
+    size_t length() const;
+
+    // True if some text did not fit into the buffer, stays set after truncate, uploads refuse such path
+    bool overflowed() const;
+
+private:
+    char buffer[PATH_BUILDER_CAPACITY];
+    size_t used;
+    bool overflow;
+};
+
+#endif
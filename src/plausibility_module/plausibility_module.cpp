@@ -0,0 +1,86 @@
+/**
+ * File: plausibility_module.cpp
+ * Author: Joonas Nislin
+ * Date: 19.10.2026
+ * Description: This file contains implementation of PlausibilityModule.
+ * Provides functionality for streaming plausibility checks of sensor readings:
+ * - Faulty readings never enter history, so a spike does not make the next normal reading a rate fault
+ * - Rate rejected readings that stay close to each other are a real step change, the new level is
+ *   taken into history after STEP_CONFIRM_READINGS readings
+ * - Stuck is reported while the same value repeats stuckCount times or more over at least stuckMillis
+ */
+
+#include "plausibility_module.h"
+
+const char* const FAULT_NAMES[NUM_SENSOR_FAULTS] = {"ok", "nan", "range", "rate", "stuck"};
+
+// Constructor
+PlausibilityCheck::PlausibilityCheck(const PlausibilityLimits& limits) : limits(limits) {}
+
+// Function for checking reading without changing history
+SensorFault PlausibilityCheck::evaluate(const FixedPoint& value) const {
+    if (!value.isValid()) {
+        return FAULT_INVALID;
+    }
+    int32_t hundredths = value.toHundredths();
+    if (hundredths < limits.minimum || hundredths > limits.maximum) {
+        return FAULT_RANGE;
+    }
+    if (!previous.isValid()) {
+        return FAULT_NONE; // First reading has nothing to compare with
+    }
+    int32_t step = hundredths - previous.toHundredths();
+    if (limits.maxStep > 0 && (step > limits.maxStep || step < -limits.maxStep)) {
+        return FAULT_RATE;
+    }
+    if (limits.stuckCount > 0 && step == 0 && repeats + 2 >= limits.stuckCount // Previous run and this reading
+        && millis() - runStartMillis >= limits.stuckMillis) {
+        return FAULT_STUCK;
+    }
+    return FAULT_NONE;
+}
+
+// Function for checking reading and taking it into history
+SensorFault PlausibilityCheck::accept(const FixedPoint& value) {
+    SensorFault fault = evaluate(value);
+    if (fault == FAULT_INVALID || fault == FAULT_RANGE) {
+        return fault;
+    }
+    if (fault == FAULT_RATE) {
+        // Spike is kept out of history, a reading close to the previous rejected one confirms a step change
+        int32_t step = stepCandidate.isValid() ? value.toHundredths() - stepCandidate.toHundredths() : 0;
+        if (stepCandidate.isValid() && step <= limits.maxStep && step >= -limits.maxStep) {
+            stepConfirmations++;
+        } else {
+            stepConfirmations = 1;
+        }
+        stepCandidate = value;
+        if (stepConfirmations < STEP_CONFIRM_READINGS) {
+            return fault;
+        }
+        fault = FAULT_NONE; // Signal stays at new level, take it into history
+    }
+    stepCandidate = FixedPoint::invalid();
+    stepConfirmations = 0;
+
+    if (previous.isValid() && value.toHundredths() == previous.toHundredths()) {
+        if (repeats < 255) {
+            repeats++;
+        }
+    } else {
+        repeats = 0;
+        runStartMillis = millis();
+    }
+    previous = value; // Stuck reading equals previous, only its run grows
+    return fault;
+}
+
+// Function for checking if fault may go away when sensor is read again
+bool PlausibilityCheck::isRetryable(SensorFault fault) {
+    return fault == FAULT_INVALID || fault == FAULT_RANGE || fault == FAULT_RATE;
+}
+
+// Function for getting short name of fault
+const char* PlausibilityCheck::getFaultName(SensorFault fault) {
+    return fault < NUM_SENSOR_FAULTS ? FAULT_NAMES[fault] : "?";
+}
@@ -0,0 +1,62 @@
+/**
+ * File: plausibility_module.h
+ * Author: Joonas Nislin
+ * Date: 19.10.2026
+ * Description: This file contains header file of PlausibilityModule.
+ * Holds declarations for checking sensor readings against limits and recent history.
+ */
+
+#ifndef PLAUSIBILITY_MODULE_H
+#define PLAUSIBILITY_MODULE_H
+
+#include <ESP8266WiFi.h>
+#include "../fixed_point/fixed_point.h"
+
+// Faults a reading can have, ordered so that faults fixed by reading again come first
+enum SensorFault : uint8_t {
+    FAULT_NONE,
+    FAULT_INVALID, // NaN or failed read
+    FAULT_RANGE, // Outside physical range of sensor
+    FAULT_RATE, // Changed more than possible since previous reading
+    FAULT_STUCK, // Same value too many times in a row
+    NUM_SENSOR_FAULTS
+};
+
+// Structure to represent limits of one metric, values are in hundredths
+struct PlausibilityLimits {
+    int32_t minimum;
+    int32_t maximum;
+    int32_t maxStep; // Largest change between readings, 0 disables rate check
+    uint8_t stuckCount; // Identical readings in a row counted as stuck, 0 disables stuck check
+    unsigned long stuckMillis; // Shortest time the identical readings must span to count as stuck
+};
+
+class PlausibilityCheck {
+public:
+    explicit PlausibilityCheck(const PlausibilityLimits& limits);
+
+    // Check reading against limits and history without changing history
+    SensorFault evaluate(const FixedPoint& value) const;
+
+    // Check reading and take it into history, returns fault of reading
+    SensorFault accept(const FixedPoint& value);
+
+    // Check if fault may go away when sensor is read again
+    static bool isRetryable(SensorFault fault);
+
+    // Get short name of fault
+    static const char* getFaultName(SensorFault fault);
+
+private:
+    PlausibilityLimits limits;
+    FixedPoint previous; // Latest plausible reading, rate is checked against it
+    uint8_t repeats = 0; // Readings equal to previous
+    unsigned long runStartMillis = 0; // Time of first reading in current run of identical readings
+    FixedPoint stepCandidate; // Latest reading rejected for rate, a real step change repeats it
+    uint8_t stepConfirmations = 0; // Rate rejected readings in a row close to each other
+
+    // Constants and Configuration Settings
+    const uint8_t STEP_CONFIRM_READINGS = 3; // Readings in a row at new level before step change is accepted
+};
+
+#endif
@@ -0,0 +1,100 @@
+/**
+ * File: power_module.cpp
+ * Author: Joonas Nislin
+ * Date: 19.10.2026
+ * Description: This file contains implementation of PowerModule.
+ * Provides functionality for keeping sensor peripherals off between readings:
+ * - Peripherals with a power pin are switched through it, others are only accounted
+ * - Warm-ups overlap: peripherals are switched on early and readers only wait for the remaining time
+ * - On-time is accounted per peripheral and converted to estimated mAh per day from profile currents
+ * Currents are datasheet typical values, measure the board to tune them.
+ */
+
+#include "power_module.h"
+#include "../log_module/log_module.h"
+
+#define LOG_TAG "power"
+
+PowerModule powerModule;
+
+// Power switch, warm-up and current draw of each peripheral
+const PeripheralProfile PERIPHERAL_PROFILES[NUM_PERIPHERALS] = {
+    {"soil probes", 14, 1000, 5.0F, 0.0F}, // Relay powering all soil moisture probes
+    {"environment", POWER_PIN_NONE, 0, 1.5F, 0.05F}, // Sensors sleep between forced measurements
+    {"ultrasonic", POWER_PIN_NONE, 0, 8.0F, 2.0F}, // Add a power switch pin to cut quiescent current
+    {"photoresistor", POWER_PIN_NONE, 0, 0.3F, 0.3F}, // Divider draws the same current on and off
+};
+
+// Function for setting power pins and switching peripherals off
+void PowerModule::setup() {
+    for (int i = 0; i < NUM_PERIPHERALS; i++) {
+        if (PERIPHERAL_PROFILES[i].powerPin != POWER_PIN_NONE) {
+            pinMode(PERIPHERAL_PROFILES[i].powerPin, OUTPUT);
+            digitalWrite(PERIPHERAL_PROFILES[i].powerPin, LOW);
+        }
+    }
+}
+
+// Function for switching peripheral on
+void PowerModule::powerOn(Peripheral peripheral) {
+    if (powered[peripheral]) {
+        return;
+    }
+    if (PERIPHERAL_PROFILES[peripheral].powerPin != POWER_PIN_NONE) {
+        digitalWrite(PERIPHERAL_PROFILES[peripheral].powerPin, HIGH);
+    }
+    powered[peripheral] = true;
+    poweredSince[peripheral] = millis();
+}
+
+// Function for switching peripheral on and waiting for remaining warm-up
+void PowerModule::ensureOn(Peripheral peripheral) {
+    powerOn(peripheral);
+    unsigned long elapsed = millis() - poweredSince[peripheral];
+    if (elapsed < PERIPHERAL_PROFILES[peripheral].warmUpMs) {
+        delay(PERIPHERAL_PROFILES[peripheral].warmUpMs - elapsed);
+    }
+}
+
+// Function for switching peripheral off
+void PowerModule::powerOff(Peripheral peripheral) {
+    if (!powered[peripheral]) {
+        return;
+    }
+    if (PERIPHERAL_PROFILES[peripheral].powerPin != POWER_PIN_NONE) {
+        digitalWrite(PERIPHERAL_PROFILES[peripheral].powerPin, LOW);
+    }
+    powered[peripheral] = false;
+    onMillis[peripheral] += millis() - poweredSince[peripheral];
+}
+
+// Function for getting on-time including current on period
+unsigned long PowerModule::getOnMillis(Peripheral peripheral) const {
+    return onMillis[peripheral] + (powered[peripheral] ? millis() - poweredSince[peripheral] : 0);
+}
+
+// Function for printing on-time and estimated charge per day
+void PowerModule::printReport() const {
+    unsigned long uptime = millis();
+    if (uptime == 0) {
+        return;
+    }
+
+    float totalMahPerDay = 0.0F;
+    for (int i = 0; i < NUM_PERIPHERALS; i++) {
+        const PeripheralProfile& profile = PERIPHERAL_PROFILES[i];
+        unsigned long on = getOnMillis((Peripheral)i);
+        float dutyCycle = (float)on / uptime;
+        float averageMa = dutyCycle * profile.activeMa + (1.0F - dutyCycle) * profile.offMa;
+        float mahPerDay = averageMa * 24.0F;
+        totalMahPerDay += mahPerDay;
+
+        // Printed as integers, duty cycle in thousandths of percent and charge in hundredths of mAh
+        unsigned long dutyMilliPercent = (unsigned long)((uint64_t)on * 100000 / uptime);
+        unsigned long mahHundredths = (unsigned long)(mahPerDay * 100.0F + 0.5F);
+        LOG_DEBUG("%s: on %lu ms (%lu.%03lu %%), estimated %lu.%02lu mAh/day", profile.name, on,
+                  dutyMilliPercent / 1000, dutyMilliPercent % 1000, mahHundredths / 100, mahHundredths % 100);
+    }
+    unsigned long totalHundredths = (unsigned long)(totalMahPerDay * 100.0F + 0.5F);
+    LOG_INFO("Sensors total: estimated %lu.%02lu mAh/day", totalHundredths / 100, totalHundredths % 100);
+}
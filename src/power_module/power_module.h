@@ -0,0 +1,63 @@
+/**
+ * File: power_module.h
+ * Author: Joonas Nislin
+ * Date: 19.10.2026
+ * Description: This file contains header file of PowerModule.
+ * Holds function declarations and constants for switching sensor peripherals on only for their readings.
+ */
+
+#ifndef POWER_MODULE_H
+#define POWER_MODULE_H
+
+#include <ESP8266WiFi.h>
+
+#define POWER_PIN_NONE -1 // Peripheral has no power switch, it is only accounted
+
+// Peripherals switched and accounted by PowerModule
+enum Peripheral {
+    PERIPHERAL_SOIL_PROBES, // YL-69 probes behind relay
+    PERIPHERAL_ENVIRONMENT, // DHT22 and BMP280 (forced mode) or BME280
+    PERIPHERAL_ULTRASONIC, // HC-SR04P
+    PERIPHERAL_PHOTORESISTOR, // Photoresistor voltage divider
+    NUM_PERIPHERALS
+};
+
+// Structure to represent power switch and current draw of one peripheral
+struct PeripheralProfile {
+    const char* name;
+    int powerPin; // Pin switching supply, POWER_PIN_NONE if always supplied
+    unsigned long warmUpMs; // Time from power on until reading is valid
+    float activeMa; // Current while on
+    float offMa; // Current while off, quiescent current if supply is not switched
+};
+
+class PowerModule {
+public:
+    // Set power pins as outputs and switch everything off
+    void setup();
+
+    // Switch peripheral on without waiting, warm-up runs while other work is done
+    void powerOn(Peripheral peripheral);
+
+    // Switch peripheral on if needed and wait until its warm-up has passed
+    void ensureOn(Peripheral peripheral);
+
+    // Switch peripheral off and account its on-time
+    void powerOff(Peripheral peripheral);
+
+    // Total on-time of peripheral since boot in milliseconds
+    unsigned long getOnMillis(Peripheral peripheral) const;
+
+    // Print on-time and estimated charge per day of each peripheral
+    void printReport() const;
+
+private:
+    bool powered[NUM_PERIPHERALS] = {false};
+    unsigned long poweredSince[NUM_PERIPHERALS] = {0};
+    unsigned long onMillis[NUM_PERIPHERALS] = {0};
+};
+
+// Power management shared by DeviceManager and SensorManager
+extern PowerModule powerModule;
+
+#endif
@@ -0,0 +1,105 @@
+/**
+ * File: sampling_module.cpp
+ * Author: Joonas Nislin
+ * Date: 19.10.2026
+ * Description: This file contains implementation of SamplingModule.
+ * Provides functionality for adapting sampling interval of each metric within configured bounds:
+ * - A change of at least SIGNIFICANT_STEP halves the interval right away, e.g. at sunrise or after watering
+ * - While moving average of changes stays below a quarter of it, interval grows by half per sample
+ * - Events such as pump runs narrow interval of affected metric to minimum
+ * Metrics due within half of minimum interval are sampled in the same cycle, so uploads stay batched.
+ */
+
+#include "sampling_module.h"
+#include "../log_module/log_module.h"
+
+#define LOG_TAG "sampling"
+
+SamplingScheduler sampler;
+const char* const METRIC_NAMES[NUM_SAMPLED_METRICS] = {"temperature", "humidity", "air_pressure", "luminosity", "water_tank_level"};
+
+// Function for setting interval bounds
+void SamplingScheduler::setBounds(unsigned long minInterval, unsigned long baseInterval, unsigned long maxInterval) {
+    this->minInterval = minInterval;
+    this->baseInterval = baseInterval;
+    this->maxInterval = maxInterval;
+
+    // Keep adapted intervals, only move them inside new bounds
+    for (int i = 0; i < NUM_SAMPLED_METRICS; i++) {
+        MetricSchedule& schedule = schedules[i];
+        if (schedule.interval == 0) {
+            schedule.interval = baseInterval;
+        }
+        schedule.interval = constrain(schedule.interval, minInterval, maxInterval);
+    }
+}
+
+// Function for checking if any metric is due
+bool SamplingScheduler::isAnyDue(unsigned long currentMillis) const {
+    for (int i = 0; i < NUM_SAMPLED_METRICS; i++) {
+        const MetricSchedule& schedule = schedules[i];
+        if (!schedule.sampled || currentMillis - schedule.lastSampleMillis >= schedule.interval) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Function for checking if metric is sampled in cycle started now
+bool SamplingScheduler::shouldSample(SampledMetric metric, unsigned long currentMillis) const {
+    const MetricSchedule& schedule = schedules[metric];
+    return !schedule.sampled || currentMillis - schedule.lastSampleMillis + minInterval / 2 >= schedule.interval;
+}
+
+// Function for recording sample and adapting interval
+void SamplingScheduler::recordSample(SampledMetric metric, const FixedPoint& value, unsigned long currentMillis) {
+    MetricSchedule& schedule = schedules[metric];
+    schedule.lastSampleMillis = currentMillis;
+    schedule.sampled = true;
+    schedule.samples++;
+    if (!value.isValid()) {
+        return; // Faulty reading tells nothing about the signal
+    }
+
+    if (schedule.previous.isValid()) {
+        int32_t step = value.toHundredths() - schedule.previous.toHundredths();
+        if (step < 0) {
+            step = -step;
+        }
+        schedule.averageStep = (3 * schedule.averageStep + step) / 4;
+
+        if (step >= SIGNIFICANT_STEP[metric]) {
+            schedule.interval = max(schedule.interval / 2, minInterval); // Signal moves, follow it closely
+        } else if (schedule.averageStep < SIGNIFICANT_STEP[metric] / 4) {
+            schedule.interval = min(schedule.interval + schedule.interval / 2, maxInterval); // Signal is calm
+        }
+    }
+    schedule.previous = value;
+}
+
+// Function for narrowing interval after event
+void SamplingScheduler::notifyEvent(SampledMetric metric) {
+    schedules[metric].interval = minInterval;
+}
+
+// Function for getting current interval of metric
+unsigned long SamplingScheduler::getInterval(SampledMetric metric) const {
+    return schedules[metric].interval;
+}
+
+// Function for printing samples per day of each metric against fixed interval
+void SamplingScheduler::printStats() const {
+    unsigned long uptime = millis();
+    if (uptime == 0 || baseInterval == 0) {
+        return;
+    }
+    for (int i = 0; i < NUM_SAMPLED_METRICS; i++) {
+        const MetricSchedule& schedule = schedules[i];
+        // Fixed interval samples right after boot and then once per base interval
+        unsigned long fixedSamples = uptime / baseInterval + 1;
+        LOG_DEBUG("Sampling %s: interval %lu s, %lu samples (%lu per day), fixed interval: %lu samples (%lu per day)",
+                  METRIC_NAMES[i], schedule.interval / 1000, schedule.samples,
+                  (unsigned long)((uint64_t)schedule.samples * MILLIS_PER_DAY / uptime),
+                  fixedSamples, MILLIS_PER_DAY / baseInterval);
+    }
+}
@@ -0,0 +1,72 @@
+/**
+ * File: sampling_module.h
+ * Author: Joonas Nislin
+ * Date: 19.10.2026
+ * Description: This file contains header file of SamplingModule.
+ * Holds declarations for scheduling each metric with its own interval adapted to recent changes.
+ */
+
+#ifndef SAMPLING_MODULE_H
+#define SAMPLING_MODULE_H
+
+#include <ESP8266WiFi.h>
+#include "../fixed_point/fixed_point.h"
+
+// Metrics read in sensor cycle, each one has its own interval
+enum SampledMetric : uint8_t {
+    SAMPLE_TEMPERATURE,
+    SAMPLE_HUMIDITY,
+    SAMPLE_AIR_PRESSURE,
+    SAMPLE_LUMINOSITY,
+    SAMPLE_WATER_TANK_LEVEL,
+    NUM_SAMPLED_METRICS
+};
+
+// Structure to represent schedule of one metric
+struct MetricSchedule {
+    unsigned long interval; // Milliseconds until next sample
+    unsigned long lastSampleMillis;
+    bool sampled; // False until first sample, metric is due right away
+    FixedPoint previous; // Latest valid sample, change is measured against it
+    int32_t averageStep; // Moving average of change between samples in hundredths
+    unsigned long samples; // Samples taken since boot
+};
+
+class SamplingScheduler {
+public:
+    // Set interval bounds, intervals start from base interval, equal bounds give fixed interval
+    void setBounds(unsigned long minInterval, unsigned long baseInterval, unsigned long maxInterval);
+
+    // Check if any metric is due, sensor cycle is started then
+    bool isAnyDue(unsigned long currentMillis) const;
+
+    // Check if metric should be sampled in the cycle started now, metrics due soon are sampled along
+    bool shouldSample(SampledMetric metric, unsigned long currentMillis) const;
+
+    // Record sample and adapt interval of metric to its change, invalid sample keeps interval
+    void recordSample(SampledMetric metric, const FixedPoint& value, unsigned long currentMillis);
+
+    // Narrow interval of metric to minimum after event that changes it, e.g. pump run for water tank level
+    void notifyEvent(SampledMetric metric);
+
+    // Get current interval of metric
+    unsigned long getInterval(SampledMetric metric) const;
+
+    // Print interval and samples per day of each metric against fixed interval
+    void printStats() const;
+
+private:
+    MetricSchedule schedules[NUM_SAMPLED_METRICS] = {};
+    unsigned long minInterval = 0;
+    unsigned long baseInterval = 0;
+    unsigned long maxInterval = 0;
+
+    // Constants and Configuration Settings
+    // Change between samples in hundredths that is worth sampling faster: 0.5 *C, 2 %, 0.5 hPa, 30 / 1023, 1 cm
+    const int32_t SIGNIFICANT_STEP[NUM_SAMPLED_METRICS] = {50, 200, 50, 3000, 100};
+    const unsigned long MILLIS_PER_DAY = 24L * 60L * 60L * 1000L;
+};
+
+extern SamplingScheduler sampler;
+
+#endif
@@ -0,0 +1,66 @@
+/**
+ * File: sensor_drivers.cpp
+ * Author: Joonas Nislin
+ * Date: 19.10.2026
+ * Description: This file contains implementation of environmental sensor drivers.
+ * Only the driver selected in sensor_drivers.h is compiled, so only its library needs to be installed.
+ */
+
+#include "sensor_drivers.h"
+#include "../watchdog_module/watchdog_module.h"
+#include <math.h>
+
+// Function for converting pressure in pascals, NaN of failed conversion gives invalid value
+static FixedPoint toAirPressure(float pascals) {
+    if (isnan(pascals)) {
+        return FixedPoint::invalid();
+    }
+    return FixedPoint::fromHundredths((int32_t)pascals); // Pascals are hundredths of hPa
+}
+
+#ifdef ENVIRONMENT_SENSOR_BME280
+
+// Function for initializing BME280 in forced mode, it sleeps between readings
+void Bme280Driver::begin(int sdaPin, int sclPin) {
+    Wire.begin(sdaPin, sclPin); // Initialize I2C communication with specified pins
+    bme.begin(BME280_ADDRESS);
+    bme.setSampling(Adafruit_BME280::MODE_FORCED, Adafruit_BME280::SAMPLING_X1, Adafruit_BME280::SAMPLING_X1,
+                    Adafruit_BME280::SAMPLING_X1, Adafruit_BME280::FILTER_OFF);
+}
+
+// Function for reading all values from one forced measurement
+void Bme280Driver::read(EnvironmentReading& reading) {
+    unsigned long startMicros = micros();
+    bme.takeForcedMeasurement(); // Single conversion, values below are read from its result registers
+    reading.temperature = FixedPoint::fromFloat(bme.readTemperature());
+    reading.humidity = FixedPoint::fromFloat(bme.readHumidity());
+    reading.airPressure = toAirPressure(bme.readPressure());
+    reading.readMicros = micros() - startMicros;
+}
+
+#else
+
+// Function for initializing DHT22 and BMP280, BMP280 sleeps between forced measurements
+void Dht22Bmp280Driver::begin(int sdaPin, int sclPin) {
+    Wire.begin(sdaPin, sclPin); // Initialize I2C communication with specified pins for BMP280
+    bmp.begin(BMP280_ADDRESS); // Initialize BMP280 sensor with specified I2C address
+    bmp.setSampling(Adafruit_BMP280::MODE_FORCED, Adafruit_BMP280::SAMPLING_X1, Adafruit_BMP280::SAMPLING_X1,
+                    Adafruit_BMP280::FILTER_OFF); // Weather monitoring settings from datasheet
+    dht.begin(); // Initialize DHT sensor
+}
+
+// Function for reading all values, DHT22 is read in one transaction for both values
+void Dht22Bmp280Driver::read(EnvironmentReading& reading) {
+    unsigned long startMicros = micros();
+
+    watchdog.enter(STAGE_DHT_READ);
+    reading.temperature = FixedPoint::fromFloat(dht.readTemperature()); // Runs the DHT22 transaction
+    reading.humidity = FixedPoint::fromFloat(dht.readHumidity()); // Served from the same transaction
+    watchdog.exit(STAGE_DHT_READ);
+
+    bmp.takeForcedMeasurement(); // Single conversion, sensor returns to sleep after it
+    reading.airPressure = toAirPressure(bmp.readPressure());
+    reading.readMicros = micros() - startMicros;
+}
+
+#endif
@@ -0,0 +1,84 @@
+/**
+ * File: sensor_drivers.h
+ * Author: Joonas Nislin
+ * Date: 19.10.2026
+ * Description: This file contains header file of environmental sensor drivers.
+ * Holds driver classes for temperature, humidity and air pressure, one of which is selected at compile time:
+ * - Dht22Bmp280Driver: DHT22 for temperature and humidity, BMP280 in forced mode for air pressure (default)
+ * - Bme280Driver: BME280 for all three in one forced measurement, define ENVIRONMENT_SENSOR_BME280 in config.h
+ * Every driver provides NAME, SINGLE_BURST, begin() and read(), SensorManager calls them without virtual dispatch.
+ */
+
+#ifndef SENSOR_DRIVERS_H
+#define SENSOR_DRIVERS_H
+
+#include <ESP8266WiFi.h>
+#include <Wire.h>
+#include <Adafruit_Sensor.h>
+#include "../fixed_point/fixed_point.h"
+#include "../../config/config.h"
+
+// Structure to represent one reading of all environmental values
+struct EnvironmentReading {
+    FixedPoint temperature; // *C
+    FixedPoint humidity; // %
+    FixedPoint airPressure; // hPa
+    unsigned long readMicros; // Time spent in read
+};
+
+#ifdef ENVIRONMENT_SENSOR_BME280
+
+#include <Adafruit_BME280.h>
+
+class Bme280Driver {
+public:
+    static constexpr const char* NAME = "BME280";
+    static constexpr bool SINGLE_BURST = true; // One conversion and register burst for all values
+
+    // Initialize I2C and sensor
+    void begin(int sdaPin, int sclPin);
+
+    // Read temperature, humidity and air pressure
+    void read(EnvironmentReading& reading);
+
+private:
+    Adafruit_BME280 bme;
+
+    // Constants and Configuration Settings
+    const uint8_t BME280_ADDRESS = 0x76;
+};
+
+typedef Bme280Driver EnvironmentDriver;
+
+#else
+
+#include <Adafruit_BMP280.h>
+#include <DHT.h>
+
+#define DHT_TYPE DHT22
+#define DIGITAL_DHT22_PIN 2
+
+class Dht22Bmp280Driver {
+public:
+    static constexpr const char* NAME = "DHT22+BMP280";
+    static constexpr bool SINGLE_BURST = false; // Bit-banged DHT22 transaction plus BMP280 read
+
+    // Initialize I2C and sensors
+    void begin(int sdaPin, int sclPin);
+
+    // Read temperature, humidity and air pressure
+    void read(EnvironmentReading& reading);
+
+private:
+    Adafruit_BMP280 bmp; // BMP280 sensor
+    DHT dht{DIGITAL_DHT22_PIN, DHT_TYPE}; // DHT22 sensor
+
+    // Constants and Configuration Settings
+    const uint8_t BMP280_ADDRESS = 0x76;
+};
+
+typedef Dht22Bmp280Driver EnvironmentDriver;
+
+#endif
+
+#endif
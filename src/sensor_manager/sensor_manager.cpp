@@ -5,149 +5,222 @@
  * Description: This file contains implementation of SensorManager.
  * Provides functionality for reading sensors
  * Sensors and actuators:
- * - DHT22 Temperature and humidity sensor
- * - BMP280 Air pressure sensor
+ * - Environmental sensors selected in sensor_drivers.h (DHT22 and BMP280 by default)
  * - Photoresistor luminosity sensor
- * - YL-69 Soil moisture sensor
+ * - YL-69 Soil moisture sensors (one per plant, through CD74HC4051E multiplexer)
  * - Water pump
+ * Readings are checked by PlausibilityCheck before upload. A faulty reading is read again within a small
+ * retry budget. If the fault remains, its upload is skipped and the fault is reported in one event per cycle.
  */
 
 #include "sensor_manager.h"
 #include "../globals/globals.h"
+#include "../watchdog_module/watchdog_module.h"
+#include "../power_module/power_module.h"
+#include "../log_module/log_module.h"
+#include "../flash_strings/flash_strings.h"
 
-// Sensor library variables
-Adafruit_BMP280 bmp; // BMP280 sensor
-DHT dht(DIGITAL_DHT22_PIN, DHT_TYPE); // DHT22 sensor
+#define LOG_TAG "sensor"
 
 // Setup function
 void SensorManager::setup() {
-    Wire.begin(I2C_D2, I2C_D1); // Initialize I2C communication with specified pins for BMP280
-    bmp.begin(0x76); // Initialize BMP280 sensor with specified I2C address (0x76)
-    dht.begin(); // Initialize DHT sensor
+    environment.begin(I2C_D2, I2C_D1); // Initialize environmental sensors on I2C pins
+    mux.setup(); // Initialize multiplexer select pins
     pinMode(DIGITAL_HC_SR04_TRIGGER_PIN, OUTPUT);  
     pinMode(DIGITAL_HC_SR04_ECHO_PIN, INPUT); 
 }
 
-// Function for reading and sending air pressure data to firebase
-void SensorManager::readAndSendAirPressure(String deviceId, String networkName) {
-    // Read air pressure from BMP280 and convert to hPa
-    float airPressure = bmp.readPressure() / 100.0F;
+// Function for reading temperature, humidity and air pressure in one go
+void SensorManager::readEnvironment() {
+    powerModule.ensureOn(PERIPHERAL_ENVIRONMENT);
+    for (int attempt = 0; ; attempt++) {
+        environment.read(lastEnvironment);
+        bool retryable = PlausibilityCheck::isRetryable(temperatureCheck.evaluate(lastEnvironment.temperature))
+            || PlausibilityCheck::isRetryable(humidityCheck.evaluate(lastEnvironment.humidity))
+            || PlausibilityCheck::isRetryable(airPressureCheck.evaluate(lastEnvironment.airPressure));
+        if (!retryable || attempt >= MAX_READ_RETRIES) {
+            break;
+        }
+        faultStats.retries++;
+        delay(ENVIRONMENT_RETRY_DELAY); // DHT22 answers with its previous reading if read sooner
+    }
+    powerModule.powerOff(PERIPHERAL_ENVIRONMENT);
+
+    // Take readings into history, faults decide which uploads are skipped
+    temperatureFault = temperatureCheck.accept(lastEnvironment.temperature);
+    humidityFault = humidityCheck.accept(lastEnvironment.humidity);
+    airPressureFault = airPressureCheck.accept(lastEnvironment.airPressure);
+
+    // Log read latency so trait sets can be compared
+    LOG_INFO("Environment read (%s%s): %lu us", EnvironmentDriver::NAME,
+             EnvironmentDriver::SINGLE_BURST ? ", single burst" : "", lastEnvironment.readMicros);
+}
+
+// Function for sending air pressure data of latest environment reading to firebase
+FixedPoint SensorManager::readAndSendAirPressure(const String& deviceId, const String& networkName) {
+    const FixedPoint& airPressure = lastEnvironment.airPressure;
 
-    // Print air pressure reading
-    Serial.print("Air pressure: ");
-    Serial.print(airPressure);
-    Serial.println(" hPa");
+    // Log air pressure reading
+    logReading(PSTR("Air pressure"), airPressure, PSTR("hPa"));
+    if (airPressureFault != FAULT_NONE) {
+        suppressUpload(PSTR("air_pressure"), "P", airPressureFault);
+        return FixedPoint::invalid();
+    }
 
     // Send air pressure data to Firebase
     if (apiManager.encryptAndSendAirPressure(airPressure, deviceId, networkName)) {
-        Serial.println("Air pressure data sent successfully.");
+        LOG_DEBUG("Air pressure data sent successfully.");
     } else {
-        Serial.println("Failed to send air pressure data.");
+        LOG_ERROR("Failed to send air pressure data.");
         handleEvent(ERROR, SEND_AIR_PRESSURE_ERROR_MESSAGE, AIR_PRESSURE);
     }
+    return airPressure;
 }
 
-// Function for reading and sending temperature data to firebase
-void SensorManager::readAndSendTemperature(String deviceId, String networkName) {
-    float temperature = dht.readTemperature(); // Read temperature from DHT22
+// Function for sending temperature data of latest environment reading to firebase
+FixedPoint SensorManager::readAndSendTemperature(const String& deviceId, const String& networkName) {
+    const FixedPoint& temperature = lastEnvironment.temperature;
 
-    // Print temperature reading
-    Serial.print("Temperature: ");
-    Serial.print(temperature);
-    Serial.println(" *C");
+    // Log temperature reading
+    logReading(PSTR("Temperature"), temperature, PSTR("*C"));
+    if (temperatureFault != FAULT_NONE) {
+        suppressUpload(PSTR("temperature"), "T", temperatureFault);
+        return FixedPoint::invalid();
+    }
 
     // Send temperature data to Firebase
     if (apiManager.encryptAndSendTemperature(temperature, deviceId, networkName)) {
-        Serial.println("Temperature data sent successfully.");
+        LOG_DEBUG("Temperature data sent successfully.");
     } else {
-        Serial.println("Failed to send temperature data.");
+        LOG_ERROR("Failed to send temperature data.");
         handleEvent(ERROR, SEND_TEMPERATURE_ERROR_MESSAGE, TEMPERATURE);
     }
+    return temperature;
 }
 
-// Function for reading and sending humidity data to firebase
-void SensorManager::readAndSendHumidity(String deviceId, String networkName) {
-    float humidity = dht.readHumidity(); // Read humidity from DHT22
+// Function for sending humidity data of latest environment reading to firebase
+FixedPoint SensorManager::readAndSendHumidity(const String& deviceId, const String& networkName) {
+    const FixedPoint& humidity = lastEnvironment.humidity;
 
-    // Print humidity reading
-    Serial.print("Humidity: ");
-    Serial.print(humidity);
-    Serial.println(" %");
+    // Log humidity reading
+    logReading(PSTR("Humidity"), humidity, PSTR("%"));
+    if (humidityFault != FAULT_NONE) {
+        suppressUpload(PSTR("humidity"), "H", humidityFault);
+        return FixedPoint::invalid();
+    }
 
     // Send humidity data to Firebase
     if (apiManager.encryptAndSendHumidity(humidity, deviceId, networkName)) {
-        Serial.println("Humidity data sent successfully.");
+        LOG_DEBUG("Humidity data sent successfully.");
     } else {
-        Serial.println("Failed to send humidity data.");
+        LOG_ERROR("Failed to send humidity data.");
         handleEvent(ERROR, SEND_HUMIDITY_ERROR_MESSAGE, HUMIDITY);
     }
+    return humidity;
 }
 
 // Function for reading and sending luminosity data to firebase
-void SensorManager::readAndSendLuminosity(String deviceId, String networkName) {
-    int luminosity = readPhotoresistor(); // Read luminosity from photoresistor
+FixedPoint SensorManager::readAndSendLuminosity(const String& deviceId, const String& networkName) {
+    // Read luminosity from photoresistor, read again within retry budget if it is not plausible
+    int luminosity = readPhotoresistor();
+    for (int attempt = 0; PlausibilityCheck::isRetryable(luminosityCheck.evaluate(toReading(luminosity))) && attempt < MAX_READ_RETRIES; attempt++) {
+        faultStats.retries++;
+        luminosity = readPhotoresistor();
+    }
+    SensorFault fault = luminosityCheck.accept(toReading(luminosity));
 
-    // Print luminosity reading
-    Serial.print("Luminosity: ");
-    Serial.print(luminosity);
-    Serial.println(" %");
+    // Log luminosity reading
+    LOG_INFO("Luminosity: %d %%", luminosity);
+    if (fault != FAULT_NONE) {
+        suppressUpload(PSTR("luminosity"), "L", fault);
+        return FixedPoint::invalid();
+    }
 
     // Send luminosity data to Firebase
-    if (apiManager.encryptAndSendLuminosity(luminosity, deviceId, networkName)) {
-        Serial.println("Luminosity data sent successfully.");
+    if (apiManager.encryptAndSendLuminosity(FixedPoint::fromInt(luminosity), deviceId, networkName)) {
+        LOG_DEBUG("Luminosity data sent successfully.");
     } else {
-        Serial.println("Failed to send luminosity data.");
+        LOG_ERROR("Failed to send luminosity data.");
         handleEvent(ERROR, SEND_LUMINOSITY_ERROR_MESSAGE, LUMINOSITY);
     }
+    return FixedPoint::fromInt(luminosity);
 }
 
 // Function for reading photoresistor value
 int SensorManager::readPhotoresistor() {
-    // Configure Multiplexer IC 74157 to select photoresistor
-    // CD74HC4051E_CONTROL_PIN_1 is connected to ground so it stays LOW
-    digitalWrite(DIGITAL_CD74HC4051E_CONTROL_PIN_2, HIGH);
-    digitalWrite(DIGITAL_CD74HC4051E_CONTROL_PIN_3, LOW);
-    delay(10); // Short delay so that the sensor stabilizes
-    int val = analogRead(ANALOG_OUTPUT_PIN); // Read the analog value from sensor
-    return val; // Return analog luminosity value
+    // Select photoresistor channel of the multiplexer and read the analog luminosity value
+    powerModule.ensureOn(PERIPHERAL_PHOTORESISTOR);
+    int luminosity = mux.readChannel(PHOTORESISTOR_CHANNEL);
+    powerModule.powerOff(PERIPHERAL_PHOTORESISTOR);
+    return luminosity;
 }
 
-// Function for reading and sending soil moisture data to firebase
-int SensorManager::readAndSendSoilMoisture(String deviceId, String networkName) {
-    // Read soil moisture
-    int soilMoisture = readSoilMoistureSensor();
+// Function for reading and sending soil moisture data of every plant to firebase
+void SensorManager::readAndSendSoilMoisture(const MuxChannel* channels, int count, int* results, const String& deviceId, const String& networkName) {
+    // Read all soil moisture probes in one multiplexer scan
+    mux.scan(channels, count, results);
 
-    // Print soil moisture reading
-    Serial.print("Soil moisture: ");
-    Serial.print(soilMoisture);
-    Serial.println(" %");
+    // Log scan time so that cost per added channel can be followed
+    int channelCount = mux.getLastScanChannelCount();
+    unsigned long scanMicros = mux.getLastScanMicros();
+    LOG_INFO("Soil moisture scan: %d channels in %lu us (%lu us per channel)",
+             channelCount, scanMicros, channelCount > 0 ? scanMicros / channelCount : 0UL);
 
-    // Send soil moisture data to firebase
-    if (apiManager.encryptAndSendSoilMoisture(soilMoisture, deviceId, networkName)) {
-        Serial.println("Soil moisture data sent successfully.");
-    } else {
-        Serial.println("Failed to send soil moisture data.");
-        handleEvent(ERROR, SEND_SOIL_MOISTURE_ERROR_MESSAGE, SOIL_MOISTURE);
-    }
+    for (int i = 0; i < count; i++) {
+        // Log soil moisture reading
+        LOG_INFO("Soil moisture %d: %d", i, results[i]);
 
-    // Return value of soil moisture
-    return soilMoisture;
-}
+        if (results[i] < 0) {
+            char code[4]; // Soil moisture code carries channel, e.g. "S0"
+            snprintf(code, sizeof(code), "S%d", i);
+            suppressUpload(PSTR("soil_moisture"), code, FAULT_INVALID); // Channel could not be read, nothing to send
+            continue;
+        }
 
-// Function for reading soil moisture sensor value
-int SensorManager::readSoilMoistureSensor() {
-    // Configure Multiplexer IC 74157 to select soil moisture sensor
-    // CD74HC4051E_CONTROL_PIN_1 is connected to ground so it stays LOW
-    digitalWrite(DIGITAL_CD74HC4051E_CONTROL_PIN_2, LOW);
-    digitalWrite(DIGITAL_CD74HC4051E_CONTROL_PIN_3, HIGH);
-    delay(10); // Short delay so that the sensor stabilizes
-    int val = analogRead(ANALOG_OUTPUT_PIN); // Read the analog value from sensor
-    return val; // Return analog soil moisture value
+        // Send soil moisture data to firebase
+        if (apiManager.encryptAndSendSoilMoisture(results[i], i, deviceId, networkName)) {
+            LOG_DEBUG("Soil moisture data sent successfully.");
+        } else {
+            LOG_ERROR("Failed to send soil moisture data.");
+            handleEvent(ERROR, SEND_SOIL_MOISTURE_ERROR_MESSAGE, SOIL_MOISTURE);
+        }
+    }
 }
 
 // Function for reading and sending water tank level data to firebase
-float SensorManager::readAndSendWaterTankLevel(String deviceId, String networkName) {
-    // Measure water tank level with HC_SR04P
+FixedPoint SensorManager::readAndSendWaterTankLevel(const String& deviceId, const String& networkName) {
+    // Measure water tank level, ping again within retry budget if echo is missing or out of range
+    FixedPoint distance = measureDistance();
+    for (int attempt = 0; PlausibilityCheck::isRetryable(waterTankCheck.evaluate(distance)) && attempt < MAX_READ_RETRIES; attempt++) {
+        faultStats.retries++;
+        delay(ULTRASONIC_RETRY_DELAY); // Let echoes of previous ping die out
+        distance = measureDistance();
+    }
+    SensorFault fault = waterTankCheck.accept(distance);
+
+    if (fault != FAULT_NONE) {
+        suppressUpload(PSTR("water_tank_level"), "W", fault);
+        return FixedPoint::invalid(); // Tank level is unknown, watering is not allowed on it
+    }
+    // Log the measured distance
+    logReading(PSTR("Distance"), distance, PSTR("cm"));
+
+    // Send water tank level data to Firebase
+    if (apiManager.encryptAndSendWaterTankLevel(distance, deviceId, networkName)) {
+        LOG_DEBUG("Water tank level data sent successfully.");
+    } else {
+        LOG_ERROR("Failed to send water tank level data.");
+        handleEvent(ERROR, SEND_WATER_TANK_LEVEL_ERROR_MESSAGE, WATER_TANK_LEVEL);
+    }
+    
+    // Return value of distance
+    return distance;
+}
+
+// Function for measuring distance to water surface with HC_SR04P
+FixedPoint SensorManager::measureDistance() {
+    powerModule.ensureOn(PERIPHERAL_ULTRASONIC);
+    watchdog.enter(STAGE_ULTRASONIC_READ);
     // 10 µs HIGH voltage starts echo pulse
     digitalWrite(DIGITAL_HC_SR04_TRIGGER_PIN, LOW);
     delayMicroseconds(2);
@@ -155,32 +228,70 @@ float SensorManager::readAndSendWaterTankLevel(String deviceId, String networkNa
     delayMicroseconds(10);
     digitalWrite(DIGITAL_HC_SR04_TRIGGER_PIN, LOW);
 
-    // Measure the duration of the echo pulse
+    // Measure the duration of the echo pulse, 0 when no echo arrived
     unsigned long duration = pulseIn(DIGITAL_HC_SR04_ECHO_PIN, HIGH);
+    watchdog.exit(STAGE_ULTRASONIC_READ);
+    powerModule.powerOff(PERIPHERAL_ULTRASONIC);
+
+    // Calculate the distance in hundredths of centimeters, sound travels 0.0343 cm/us and the echo covers it twice
+    // Integer math stays in range for the 1 s pulseIn timeout: 1000000 * 343 < 2^31
+    return FixedPoint::fromHundredths((int32_t)((duration * 343UL + 100UL) / 200UL));
+}
 
-    // Calculate the distance in centimeters
-    float distance = (duration * 0.0343) / 2;
+// Function for converting raw multiplexer reading, failed read is invalid
+FixedPoint SensorManager::toReading(int value) {
+    return value < 0 ? FixedPoint::invalid() : FixedPoint::fromInt(value);
+}
 
-    // Check for out-of-range or error conditions
-    if (distance < 2 || distance > HC_SR04_MAX_DISTANCE_CM) {
-        // Out of range or invalid measurement
-        Serial.println("Out of range or invalid measurement");
-        return -1.0;
-    } else {
-        // Print the measured distance
-        Serial.print("Distance: ");
-        Serial.print(distance);
-        Serial.println(" cm");
+// Function for skipping upload of faulty reading and adding it to fault summary of the cycle
+void SensorManager::suppressUpload(PGM_P metric, const char* code, SensorFault fault) {
+    char metricName[24]; // Metric name is in flash
+    copyFlashString(metricName, sizeof(metricName), metric);
+    LOG_WARNING("%s reading not uploaded: %s", metricName, PlausibilityCheck::getFaultName(fault));
+
+    faultStats.faults[fault]++;
+    faultStats.suppressedUploads++;
+    size_t length = strlen(faultSummary);
+    int entryLength = snprintf(faultSummary + length, sizeof(faultSummary) - length, "%s%s %s",
+                               length > 0 ? ", " : "", code, PlausibilityCheck::getFaultName(fault));
+    if (entryLength < 0 || (size_t)entryLength >= sizeof(faultSummary) - length) {
+        faultSummary[length] = '\0'; // Whole entries only, the rest is counted
+        faultsNotInSummary++;
     }
+}
 
-    // Send water tank level data to Firebase
-    if (apiManager.encryptAndSendWaterTankLevel(distance, deviceId, networkName)) {
-        Serial.println("Water tank level data sent successfully.");
+// Function for reporting faults of the cycle as one event
+void SensorManager::reportFaults() {
+    if (faultSummary[0] == '\0' && faultsNotInSummary == 0) {
+        return;
+    }
+    char message[64]; // "Faults: " and summary and " +<count>" stay within 63 chars of plaintext
+    if (faultsNotInSummary > 0) {
+        snprintf(message, sizeof(message), "Faults: %s +%u", faultSummary, (unsigned int)faultsNotInSummary);
     } else {
-        Serial.println("Failed to send water tank level data.");
-        handleEvent(ERROR, SEND_WATER_TANK_LEVEL_ERROR_MESSAGE, WATER_TANK_LEVEL);
+        snprintf(message, sizeof(message), "Faults: %s", faultSummary);
     }
-    
-    // Return value of distance
-    return distance;
+    handleEvent(WARNING, message, SENSOR_FAULT);
+    faultSummary[0] = '\0';
+    faultsNotInSummary = 0;
+
+    LOG_INFO("Sensor faults: %lu nan, %lu range, %lu rate, %lu stuck, %lu retries, %lu uploads avoided",
+             faultStats.faults[FAULT_INVALID], faultStats.faults[FAULT_RANGE], faultStats.faults[FAULT_RATE],
+             faultStats.faults[FAULT_STUCK], faultStats.retries, faultStats.suppressedUploads);
+}
+
+// Function for getting fault counters
+const SensorFaultStats& SensorManager::getFaultStats() const {
+    return faultStats;
+}
+
+// Function for logging reading with label and unit
+void SensorManager::logReading(PGM_P label, const FixedPoint& value, PGM_P unit) {
+    char buffer[16];
+    char labelBuffer[16]; // Label and unit are in flash
+    char unitBuffer[8];
+    value.format(buffer, sizeof(buffer), 0);
+    copyFlashString(labelBuffer, sizeof(labelBuffer), label);
+    copyFlashString(unitBuffer, sizeof(unitBuffer), unit);
+    LOG_INFO("%s: %s %s", labelBuffer, buffer, unitBuffer);
 }
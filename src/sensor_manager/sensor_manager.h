@@ -10,52 +10,103 @@
 #define SENSOR_MANAGER_H
 
 #include <ESP8266WiFi.h>
-#include <Wire.h>
-#include <Adafruit_Sensor.h>
-#include <Adafruit_BMP280.h>
-#include <DHT.h>
+#include "../mux_module/mux_module.h"
+#include "../fixed_point/fixed_point.h"
+#include "../sensor_drivers/sensor_drivers.h"
+#include "../plausibility_module/plausibility_module.h"
 
-#define DHT_TYPE DHT22
-#define DIGITAL_DHT22_PIN 2
+// Structure to represent sensor fault counters for diagnostics
+struct SensorFaultStats {
+    unsigned long faults[NUM_SENSOR_FAULTS]; // Readings not uploaded, by fault
+    unsigned long retries; // Extra reads because of retryable fault
+    unsigned long suppressedUploads; // Uploads of faulty readings avoided
+};
 
 class SensorManager {
 public:
     // Setup function
     void setup();
 
-    // Read and send air pressure data to Firebase
-    void readAndSendAirPressure(String deviceId, String networkName);
+    // Read temperature, humidity and air pressure with selected driver, sent by the functions below
+    void readEnvironment();
+
+    // Send air pressure data of latest environment reading to Firebase and return it, invalid if it was not plausible
+    FixedPoint readAndSendAirPressure(const String& deviceId, const String& networkName);
 
-    // Read and send temperature data to Firebase
-    void readAndSendTemperature(String deviceId, String networkName);
+    // Send temperature data of latest environment reading to Firebase and return it, invalid if it was not plausible
+    FixedPoint readAndSendTemperature(const String& deviceId, const String& networkName);
 
-    // Read and send humidity data to Firebase
-    void readAndSendHumidity(String deviceId, String networkName);
+    // Send humidity data of latest environment reading to Firebase and return it, invalid if it was not plausible
+    FixedPoint readAndSendHumidity(const String& deviceId, const String& networkName);
 
-    // Read and send luminosity data to Firebase
-    void readAndSendLuminosity(String deviceId, String networkName);
+    // Read and send luminosity data to Firebase and return it, invalid if it was not plausible
+    FixedPoint readAndSendLuminosity(const String& deviceId, const String& networkName);
 
     // Read the photoresistor and return the light level
     int readPhotoresistor();
 
-    // Read and send soil moisture data to Firebase and return the moisture level
-    int readAndSendSoilMoisture(String deviceId, String networkName);
-    
-    // Read the soil moisture sensor and return the moisture level
-    int readSoilMoistureSensor();
+    // Scan soil moisture probes, send each reading to Firebase and store moisture levels in results
+    void readAndSendSoilMoisture(const MuxChannel* channels, int count, int* results, const String& deviceId, const String& networkName);
+
+    // Read and send water tank level data to Firebase and return the water tank level, invalid if it could not be read
+    FixedPoint readAndSendWaterTankLevel(const String& deviceId, const String& networkName);
 
-    // Read and send water tank level data to Firebase and return the water tank level
-    float readAndSendWaterTankLevel(String deviceId, String networkName);
+    // Report readings skipped during the cycle as one event
+    void reportFaults();
+
+    // Get fault counters
+    const SensorFaultStats& getFaultStats() const;
 private:
+    // Measure distance to water surface once
+    FixedPoint measureDistance();
+
+    // Convert raw multiplexer reading, negative value is a failed read
+    static FixedPoint toReading(int value);
+
+    // Skip upload of faulty reading and add its short metric code to fault summary
+    void suppressUpload(PGM_P metric, const char* code, SensorFault fault);
+
+    // Log reading formatted with two decimals, label and unit are in flash
+    void logReading(PGM_P label, const FixedPoint& value, PGM_P unit);
+
     // Constants and Configuration Settings
     const int I2C_D1 = 5;
     const int I2C_D2 = 4;
     const int ANALOG_OUTPUT_PIN = A0;
+    const int DIGITAL_CD74HC4051E_CONTROL_PIN_1 = MUX_PIN_GROUNDED; // Connected to ground so it stays LOW
     const int DIGITAL_CD74HC4051E_CONTROL_PIN_2 = 12;
     const int DIGITAL_CD74HC4051E_CONTROL_PIN_3 = 13;
     const int DIGITAL_HC_SR04_TRIGGER_PIN = 0;
     const int DIGITAL_HC_SR04_ECHO_PIN = 15;
     const int HC_SR04_MAX_DISTANCE_CM = 450;
+    const MuxChannel PHOTORESISTOR_CHANNEL = {2, 10, 0, 1023}; // Channel 2, 10 ms settle time, no calibration
+    const int MAX_READ_RETRIES = 2; // Extra reads of a faulty reading before its upload is skipped
+    const unsigned long ENVIRONMENT_RETRY_DELAY = 2000; // DHT22 minimum sampling period
+    const unsigned long ULTRASONIC_RETRY_DELAY = 60; // HC-SR04 minimum measurement cycle
+
+    const unsigned long STUCK_WINDOW = 6L * 60L * 60L * 1000L; // Identical readings must span 6 hours to be stuck
+
+    // Plausibility limits in hundredths: minimum, maximum, largest change between readings, readings in a row
+    // and shortest time span for stuck
+    PlausibilityCheck temperatureCheck{{-4000, 8000, 1000, 12, STUCK_WINDOW}}; // DHT22 range -40...80 *C
+    PlausibilityCheck humidityCheck{{0, 10000, 4000, 0, 0}}; // Stays at 100 % in fog or a closed space, no stuck check
+    PlausibilityCheck airPressureCheck{{30000, 110000, 1000, 6, STUCK_WINDOW}}; // BMP280 range 300...1100 hPa
+    PlausibilityCheck luminosityCheck{{0, 102300, 0, 0, 0}}; // Steady in dark, no stuck check
+    PlausibilityCheck waterTankCheck{{200, HC_SR04_MAX_DISTANCE_CM * 100, 0, 0, 0}}; // Refill is a legal jump
+    SensorFault temperatureFault = FAULT_NONE;
+    SensorFault humidityFault = FAULT_NONE;
+    SensorFault airPressureFault = FAULT_NONE;
+    SensorFaultStats faultStats = {{0}, 0, 0};
+    char faultSummary[52] = ""; // "<code> <fault>, ..." of the current cycle, event message stays within 63 chars
+    uint8_t faultsNotInSummary = 0; // Faults of the current cycle that did not fit the summary
+
+    // Temperature, humidity and air pressure sensors selected at compile time
+    EnvironmentDriver environment;
+    EnvironmentReading lastEnvironment;
+
+    // CD74HC4051E multiplexer for photoresistor and soil moisture probes
+    MuxModule mux{DIGITAL_CD74HC4051E_CONTROL_PIN_1, DIGITAL_CD74HC4051E_CONTROL_PIN_2,
+                  DIGITAL_CD74HC4051E_CONTROL_PIN_3, ANALOG_OUTPUT_PIN};
 };
 
 #endif
\ No newline at end of file
@@ -13,8 +13,10 @@
 #include <AESLib.h>
 #include "../../config/config.h"
 #include "time_module.h"
+#include "../watchdog_module/watchdog_module.h"
 
 const long TIMEZONE_OFFSET = 3 * 3600; // +3:00 hours
+const unsigned long SECONDS_PER_DAY = 24L * 3600L;
 
 WiFiUDP ntpUDP; // Create a UDP client for NTP (Network Time Protocol) communication
 NTPClient timeClient(ntpUDP, "pool.ntp.org");  // Create an NTPClient instance with the UDP client and set the NTP server
@@ -26,6 +28,7 @@ void timeModuleInit() {
 
 // Update the current time from the NTP server
 void updateTime() {
+    WatchdogScope watchdogScope(STAGE_NTP_UPDATE);
     timeClient.update();
 }
 
@@ -34,8 +37,8 @@ unsigned long getCurrentEpochTime() {
     return timeClient.getEpochTime();
 }
 
-// Get the formatted date as "YYYY/MM/DD" with the current time adjusted for the timezone offset
-String getFormattedDate() {
+// Get the formatted date as "YYYY/MM/DD/" with the current time adjusted for the timezone offset
+void getFormattedDate(char* buffer, size_t size) {
     updateTime();
 
     // Get the current epoch time
@@ -52,17 +55,34 @@ String getFormattedDate() {
     int year = timeElements.Year + 1970; // Year count starts from 1970
     int month = timeElements.Month;
     int day = timeElements.Day;
-    int hour = timeElements.Hour;
 
-    // Format the date as "YYYY/MM/DD" and return it
-    String formattedDate = String(year) + "/" + (month < 10 ? "0" : "") + String(month) + "/" + (day < 10 ? "0" : "") + String(day) + "/";
-    return formattedDate;
+    // Format the date as "YYYY/MM/DD/" into buffer
+    snprintf(buffer, size, "%d/%02d/%02d/", year, month, day);
 }
 
-// Get the current time as a formatted string (epoch time)
-String getCurrentTimeAsString() {
+// Get the formatted date as "YYYY/MM/DD/" String
+String getFormattedDate() {
+    char buffer[FORMATTED_DATE_LENGTH];
+    getFormattedDate(buffer, sizeof(buffer));
+    return String(buffer);
+}
+
+// Get the current time as a formatted string (epoch time) into buffer
+void getCurrentTimeAsString(char* buffer, size_t size) {
     updateTime();
     // Get current epoch time
-    time_t currentEpochTime = timeClient.getEpochTime();
-    return String(currentEpochTime);
+    snprintf(buffer, size, "%lu", timeClient.getEpochTime());
+}
+
+// Get the current time as a formatted string (epoch time)
+String getCurrentTimeAsString() {
+    char buffer[EPOCH_STRING_LENGTH];
+    getCurrentTimeAsString(buffer, sizeof(buffer));
+    return String(buffer);
+}
+
+// Get epoch time of local midnight, readings of one formatted date share it
+unsigned long getLocalDayStartEpoch(unsigned long epoch) {
+    unsigned long localEpoch = epoch + TIMEZONE_OFFSET;
+    return localEpoch - localEpoch % SECONDS_PER_DAY - TIMEZONE_OFFSET;
 }
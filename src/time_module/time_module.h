@@ -11,10 +11,16 @@
 
 #include <ESP8266WiFi.h>
 
+#define FORMATTED_DATE_LENGTH 12 // "YYYY/MM/DD/" and terminator
+#define EPOCH_STRING_LENGTH 11 // 32-bit epoch time and terminator
+
 void timeModuleInit(); // Initialize the TimeModule
 void updateTime(); // Update the current time
 unsigned long getCurrentEpochTime(); // Get the current epoch time
-String getFormattedDate(); // Get the formatted date as a string (YYYY/MM/DD)
+String getFormattedDate(); // Get the formatted date as a string (YYYY/MM/DD/)
+void getFormattedDate(char* buffer, size_t size); // Write the formatted date (YYYY/MM/DD/) into buffer
 String getCurrentTimeAsString(); // Get the current time as a formatted string (epoch time)
+void getCurrentTimeAsString(char* buffer, size_t size); // Write the current time (epoch time) into buffer
+unsigned long getLocalDayStartEpoch(unsigned long epoch); // Get epoch time of local midnight of the date of epoch
 
 #endif
@@ -0,0 +1,271 @@
+/**
+ * File: transport_module.cpp
+ * Author: Joonas Nislin
+ * Date: 19.10.2026
+ * Description: This file contains implementation of TransportModule.
+ * Provides functionality for uploading through REST or MQTT behind one interface.
+ * MQTT uses one session kept open between uploads instead of a request and response per update:
+ * - Uploads are published at QoS 1, an upload is delivered only when the broker answers with PUBACK
+ * - Upload without PUBACK after all attempts is kept in a small queue and published again from loop
+ * - Session is persistent (clean session off), so broker keeps session state over reconnects
+ * - Last will marks the device offline on "<prefix>/<deviceId>/status"
+ * - Topics are short, "<prefix>/<deviceId>/<tree>/<key>", date and encrypted SSID are left out of them
+ * - Encrypted SSID is published retained on "<prefix>/<deviceId>/network", a broker side bridge restores
+ *   database paths from it and applies uploads as PATCH
+ * Redelivery makes delivery at least once, the bridge applies PATCH so a duplicate writes the same values.
+ * Uses arduino-mqtt (lwmqtt) library when TRANSPORT_MQTT is defined.
+ */
+
+#include "transport_module.h"
+#include "../firebase_module/firebase_module.h"
+#include "../circuit_breaker/circuit_breaker.h"
+#include "../log_module/log_module.h"
+
+#define LOG_TAG "transport"
+
+// Function for uploading with retries through upload breaker
+bool Transport::send(const JsonWriter& json, const PathBuilder& nodePath) {
+    if (json.overflowed() || nodePath.overflowed()) {
+        LOG_ERROR("Path or payload cut off, upload refused: %s", nodePath.c_str());
+        return false; // Retrying does not help
+    }
+    if (!uploadBreaker.allowRequest()) {
+        return false; // Backend is down, do not spend power on it
+    }
+
+    bool success = deliver(json, nodePath);
+    for (int attempt = 1; !success && uploadBreaker.backoff(attempt); attempt++) {
+        success = deliver(json, nodePath);
+    }
+    uploadBreaker.recordResult(success);
+    if (!success) {
+        keepForRetry(json, nodePath);
+    }
+    return success;
+}
+
+// Function for getting transport statistics
+const TransportStats& Transport::getStats() const {
+    return stats;
+}
+
+// Function for printing transport statistics
+void Transport::printStats() const {
+    LOG_INFO("Transport %s: %lu messages, %lu failures, %lu bytes per message", name(),
+             (unsigned long)stats.messages, (unsigned long)stats.failures,
+             (unsigned long)(stats.messages > 0 ? stats.bytes / stats.messages : 0));
+}
+
+// Function for accounting upload result
+void Transport::record(bool success, size_t bytes) {
+    if (success) {
+        stats.messages++;
+        stats.bytes += bytes;
+    } else {
+        stats.failures++;
+    }
+}
+
+// Function for uploading through firebase REST API
+bool FirebaseTransport::deliver(const JsonWriter& json, const PathBuilder& nodePath) {
+    bool success = sendFirebaseData(json, nodePath);
+    // "PATCH /<path>.json?print=silent&auth=<secret> HTTP/1.1\r\n" and body, headers are added by HTTPClient
+    size_t requestLine = strlen("PATCH /.json?print=silent&auth= HTTP/1.1\r\n") + nodePath.length() + strlen(FIREBASE_AUTH);
+    record(success, requestLine + json.length());
+    return success;
+}
+
+// Function for getting transport name
+const char* FirebaseTransport::name() const {
+    return "REST";
+}
+
+#ifdef TRANSPORT_MQTT
+
+// Function for setting session identity and broker
+void MqttTransport::begin(const String& deviceId) {
+    snprintf(clientId, sizeof(clientId), "verdantsync-%s", deviceId.c_str());
+    snprintf(this->deviceId, sizeof(this->deviceId), "%s", deviceId.c_str());
+    snprintf(statusTopic, sizeof(statusTopic), "%s/%s/status", MQTT_TOPIC_PREFIX, deviceId.c_str());
+
+    if (MQTT_PORT == TLS_PORT) {
+        secureClient.setInsecure();
+        // Broker that does not negotiate smaller records needs a receive buffer for a full record
+        bool smallRecords = BearSSL::WiFiClientSecure::probeMaxFragmentLength(MQTT_HOST, MQTT_PORT, TLS_FRAGMENT_LENGTH);
+        secureClient.setBufferSizes(smallRecords ? TLS_FRAGMENT_LENGTH : TLS_RECORD_LENGTH, TLS_TX_BUFFER);
+        mqtt.begin(MQTT_HOST, MQTT_PORT, secureClient);
+    } else {
+        mqtt.begin(MQTT_HOST, MQTT_PORT, plainClient);
+    }
+    mqtt.setOptions(KEEP_ALIVE_SECONDS, false, ACK_TIMEOUT); // Persistent session, publish waits for PUBACK
+    mqtt.setWill(statusTopic, "offline", true, 1);
+    connect();
+}
+
+// Function for publishing JSON object to topic of node path
+bool MqttTransport::deliver(const JsonWriter& json, const PathBuilder& nodePath) {
+    char topic[MQTT_TOPIC_LIMIT];
+    if (json.overflowed() || !buildTopic(topic, sizeof(topic), nodePath.c_str())) {
+        record(false, 0);
+        return false;
+    }
+    return publish(topic, json.c_str(), json.length());
+}
+
+// Function for keeping upload without PUBACK for redelivery from loop
+void MqttTransport::keepForRetry(const JsonWriter& json, const PathBuilder& nodePath) {
+    if (json.overflowed() || json.length() >= JSON_PAYLOAD_LIMIT) {
+        return; // Payload was cut off, never deliver partial data
+    }
+    if (numPending == MQTT_RETRY_SLOTS) {
+        // Newest readings are worth more than oldest ones
+        memmove(&pending[0], &pending[1], (MQTT_RETRY_SLOTS - 1) * sizeof(MqttPendingMessage));
+        numPending--;
+        dropped++;
+    }
+    MqttPendingMessage& message = pending[numPending];
+    if (!buildTopic(message.topic, sizeof(message.topic), nodePath.c_str())) {
+        return;
+    }
+    memcpy(message.payload, json.c_str(), json.length() + 1);
+    message.length = json.length();
+    numPending++;
+}
+
+// Function for keeping session alive, reconnecting and redelivering queued uploads
+void MqttTransport::loop() {
+    if (!mqtt.connected()) {
+        if (!connectAttempted || millis() - lastConnectAttemptMillis >= RECONNECT_INTERVAL) {
+            connect();
+        }
+        return;
+    }
+    mqtt.loop();
+
+    // One queued upload per loop, oldest first, only while uploads are allowed
+    if (numPending > 0 && uploadBreaker.canRequest()) {
+        bool acknowledged = publish(pending[0].topic, pending[0].payload, pending[0].length);
+        uploadBreaker.recordResult(acknowledged);
+        if (acknowledged) {
+            numPending--;
+            memmove(&pending[0], &pending[1], numPending * sizeof(MqttPendingMessage));
+            redelivered++;
+        }
+    }
+}
+
+// Function for publishing at QoS 1, lwmqtt waits for PUBACK up to ACK_TIMEOUT
+bool MqttTransport::publish(const char* topic, const char* payload, size_t length) {
+    if (!mqtt.connected() && !connect()) {
+        record(false, 0);
+        return false;
+    }
+    publishNetwork(); // Bridge needs network of device before its first upload
+
+    bool acknowledged = mqtt.publish(topic, payload, (int)length, false, 1);
+    if (!acknowledged) {
+        LOG_WARNING("MQTT publish not acknowledged, error %d", (int)mqtt.lastError());
+    }
+
+    // Fixed header, remaining length varint, topic length and topic, packet id, payload
+    size_t remaining = 2 + strlen(topic) + 2 + length;
+    size_t lengthBytes = remaining < 128 ? 1 : (remaining < 16384 ? 2 : 3);
+    record(acknowledged, 1 + lengthBytes + remaining);
+    return acknowledged;
+}
+
+// Function for checking if node path segment starts with "YYYY/MM/DD/"
+static bool isDateSegment(const char* segment) {
+    const char PATTERN[] = "dddd/dd/dd/";
+    for (size_t i = 0; i < sizeof(PATTERN) - 1; i++) {
+        if (PATTERN[i] == 'd' ? !isdigit((unsigned char)segment[i]) : segment[i] != PATTERN[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Function for building compact topic of node path
+bool MqttTransport::buildTopic(char* topic, size_t size, const char* nodePath) {
+    size_t length = snprintf(topic, size, "%s/%s", MQTT_TOPIC_PREFIX, deviceId);
+    size_t deviceIdLength = strlen(deviceId);
+    const char* segment = nodePath;
+    while (*segment != '\0' && length < size) {
+        if (isDateSegment(segment)) {
+            // Date is restored by bridge from upload time, encrypted SSID joined to it from network message
+            segment += strlen("YYYY/MM/DD/");
+            size_t networkLength = strcspn(segment, "/");
+            if (networkLength < sizeof(network) && (strncmp(network, segment, networkLength) != 0 || network[networkLength] != '\0')) {
+                memcpy(network, segment, networkLength);
+                network[networkLength] = '\0';
+                networkPublished = false;
+            }
+            segment += networkLength;
+        } else {
+            size_t segmentLength = strcspn(segment, "/");
+            bool isDeviceId = segmentLength == deviceIdLength && strncmp(segment, deviceId, segmentLength) == 0;
+            if (segmentLength > 0 && !isDeviceId) {
+                length += snprintf(topic + length, size - length, "/%.*s", (int)segmentLength, segment);
+            }
+            segment += segmentLength;
+        }
+        if (*segment == '/') {
+            segment++;
+        }
+    }
+    return length < size;
+}
+
+// Function for publishing encrypted SSID retained when it changed
+void MqttTransport::publishNetwork() {
+    if (networkPublished || network[0] == '\0') {
+        return;
+    }
+    char topic[MQTT_TOPIC_LIMIT];
+    snprintf(topic, sizeof(topic), "%s/%s/network", MQTT_TOPIC_PREFIX, deviceId);
+    networkPublished = mqtt.publish(topic, network, (int)strlen(network), true, 1);
+}
+
+// Function for printing transport statistics and redelivery queue
+void MqttTransport::printStats() const {
+    Transport::printStats();
+    LOG_INFO("MQTT redelivery: %d queued, %lu delivered late, %lu dropped", numPending, redelivered, dropped);
+}
+
+// Function for getting transport name
+const char* MqttTransport::name() const {
+    return "MQTT";
+}
+
+// Function for connecting with persistent session and last will
+bool MqttTransport::connect() {
+    connectAttempted = true;
+    lastConnectAttemptMillis = millis();
+    bool connected = mqtt.connect(clientId, MQTT_USER, MQTT_PASSWORD);
+    if (connected) {
+        mqtt.publish(statusTopic, "online", 6, true, 1);
+    } else {
+        LOG_WARNING("MQTT connection failed, error %d, return code %d", (int)mqtt.lastError(), (int)mqtt.returnCode());
+    }
+    return connected;
+}
+
+MqttTransport mqttTransport;
+Transport& transport = mqttTransport;
+
+// Function for setting up MQTT transport
+void transportModuleInit(const String& deviceId) {
+    mqttTransport.begin(deviceId);
+}
+
+#else
+
+FirebaseTransport firebaseTransport;
+Transport& transport = firebaseTransport;
+
+// Function for setting up REST transport, firebase module is initialized by DeviceManager
+void transportModuleInit(const String& deviceId) {
+    (void)deviceId; // REST paths carry device id, there is no session to open
+}
+
+#endif
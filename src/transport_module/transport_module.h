@@ -0,0 +1,147 @@
+/**
+ * File: transport_module.h
+ * Author: Joonas Nislin
+ * Date: 19.10.2026
+ * Description: This file contains header file of TransportModule.
+ * Holds transport interface used by ApiManager, HistoryModule and EventModule for uploads:
+ * - FirebaseTransport: REST PATCH through sendFirebaseData (default)
+ * - MqttTransport: publish at QoS 1 over one long-lived MQTT session, define TRANSPORT_MQTT in config.h
+ */
+
+#ifndef TRANSPORT_MODULE_H
+#define TRANSPORT_MODULE_H
+
+#include <ESP8266WiFi.h>
+#include "../json_writer/json_writer.h"
+#include "../path_builder/path_builder.h"
+#include "../../config/config.h"
+
+// Structure to represent upload load of a transport
+struct TransportStats {
+    unsigned long messages; // Successful uploads
+    unsigned long failures; // Failed uploads
+    unsigned long bytes; // Bytes written for successful uploads, see name of transport for what is included
+};
+
+class Transport {
+public:
+    virtual ~Transport() {}
+
+    // Upload JSON object to node path with retries, rejected without network access while upload breaker is open
+    // Cut off path or payload is rejected before any attempt, so data never lands on wrong node
+    bool send(const JsonWriter& json, const PathBuilder& nodePath);
+
+    // Keep connection alive, called on every loop
+    virtual void loop() {}
+
+    // Transport name for serial output
+    virtual const char* name() const = 0;
+
+    const TransportStats& getStats() const;
+
+    // Print messages, failures and bytes per message
+    virtual void printStats() const;
+
+protected:
+    TransportStats stats = {0, 0, 0};
+
+    // Make one upload attempt, returns true when transport accepted it
+    virtual bool deliver(const JsonWriter& json, const PathBuilder& nodePath) = 0;
+
+    // Account upload result
+    void record(bool success, size_t bytes);
+
+    // Keep upload that failed all attempts for later delivery, transports without queue drop it
+    virtual void keepForRetry(const JsonWriter& json, const PathBuilder& nodePath) {}
+};
+
+// REST PATCH transport, bytes include request line and body but not headers
+class FirebaseTransport : public Transport {
+public:
+    const char* name() const override;
+
+protected:
+    bool deliver(const JsonWriter& json, const PathBuilder& nodePath) override;
+};
+
+#ifdef TRANSPORT_MQTT
+
+#include <MQTT.h>
+#include "../aes_module/aes_module.h"
+
+#define MQTT_TOPIC_LIMIT 128 // Prefix, device id and compact path of longest upload
+#define MQTT_NETWORK_LIMIT ENCRYPTED_HEX_LENGTH(32) // Encrypted SSID of up to 32 characters
+#define MQTT_RETRY_SLOTS 2 // Uploads kept for redelivery until broker acknowledges them
+
+// Structure to represent upload waiting for PUBACK
+struct MqttPendingMessage {
+    char topic[MQTT_TOPIC_LIMIT];
+    char payload[JSON_PAYLOAD_LIMIT];
+    size_t length;
+};
+
+// MQTT transport, payload is the JSON object and bytes are exact packet sizes
+// Topic is "<MQTT_TOPIC_PREFIX>/<deviceId>/<node path without date, encrypted SSID and device id>", e.g.
+// history/temperature/<date><encSSID>/<deviceId>/<day> -> <prefix>/<deviceId>/history/temperature/<day>
+// Encrypted SSID is published retained on "<prefix>/<deviceId>/network" when it changes, so the bridge can restore paths
+// Uploads are published at QoS 1 and count as delivered only when broker answers with PUBACK
+class MqttTransport : public Transport {
+public:
+    // Set client id used for persistent session and status topic
+    void begin(const String& deviceId);
+
+    void loop() override;
+    const char* name() const override;
+    void printStats() const override;
+
+protected:
+    bool deliver(const JsonWriter& json, const PathBuilder& nodePath) override;
+    void keepForRetry(const JsonWriter& json, const PathBuilder& nodePath) override;
+
+private:
+    WiFiClient plainClient;
+    BearSSL::WiFiClientSecure secureClient;
+    MQTTClient mqtt{JSON_PAYLOAD_LIMIT + MQTT_TOPIC_LIMIT}; // Read and write buffer fit largest publish
+    char clientId[32] = "";
+    char deviceId[24] = "";
+    char statusTopic[64] = "";
+    char network[MQTT_NETWORK_LIMIT] = ""; // Encrypted SSID left out of topics
+    bool networkPublished = false; // Retained network message matches network
+    unsigned long lastConnectAttemptMillis = 0;
+    bool connectAttempted = false;
+    MqttPendingMessage pending[MQTT_RETRY_SLOTS]; // Oldest first
+    int numPending = 0;
+    unsigned long redelivered = 0; // Queued uploads acknowledged later
+    unsigned long dropped = 0; // Queued uploads pushed out by newer ones
+
+    // Connect with persistent session, returns true if connected
+    bool connect();
+
+    // Publish at QoS 1, returns true on PUBACK
+    bool publish(const char* topic, const char* payload, size_t length);
+
+    // Build compact topic of node path and remember encrypted SSID found in it, returns false if it does not fit
+    bool buildTopic(char* topic, size_t size, const char* nodePath);
+
+    // Publish encrypted SSID retained if it changed since last publish
+    void publishNetwork();
+
+    // Constants and Configuration Settings
+    const unsigned long RECONNECT_INTERVAL = 5000; // Milliseconds between connection attempts
+    const uint16_t KEEP_ALIVE_SECONDS = 60;
+    const uint16_t TLS_PORT = 8883;
+    const int ACK_TIMEOUT = 5000; // Milliseconds to wait for PUBACK
+    const uint16_t TLS_FRAGMENT_LENGTH = 1024; // Record size asked from broker with max fragment length extension
+    const uint16_t TLS_RECORD_LENGTH = 16384; // Full record, receive buffer when broker does not negotiate smaller
+    const uint16_t TLS_TX_BUFFER = JSON_PAYLOAD_LIMIT + MQTT_TOPIC_LIMIT + 16; // Whole publish packet in one record
+};
+
+#endif
+
+// Set up selected transport
+void transportModuleInit(const String& deviceId);
+
+// Transport selected at compile time
+extern Transport& transport;
+
+#endif
@@ -0,0 +1,174 @@
+/**
+ * File: watchdog_module.cpp
+ * Author: Joonas Nislin
+ * Date: 19.10.2026
+ * Description: This file contains implementation of WatchdogModule.
+ * Provides functionality for attributing stalls and resets to the stage that caused them:
+ * - Every tracked stage writes entry and exit breadcrumbs into a ring in RTC memory
+ * - Exit after the stage limit is recorded as a stall and reported as a WARNING event
+ * - RTC memory survives watchdog and exception resets, so after such a reset the stage that
+ *   was still open and the last breadcrumbs are reported as an ERROR event
+ * A hang that never yields cannot be caught while it happens, the hardware watchdog resets the
+ * device and the open stage in RTC memory tells where it was.
+ */
+
+#include <stddef.h>
+#include "watchdog_module.h"
+#include "../globals/globals.h"
+#include "../circuit_breaker/circuit_breaker.h"
+#include "../log_module/log_module.h"
+
+#define LOG_TAG "watchdog"
+
+WatchdogModule watchdog;
+
+// Stage names used in serial output and events
+const char* const STAGE_NAMES[NUM_WATCHDOG_STAGES] = {
+    "none", "setup", "wifi", "ntp", "fb_read", "fb_write", "commands", "sensors",
+    "dht", "ultrasonic", "soil", "watering", "events", "auth", "ota"
+};
+
+// Longest expected time of each stage in milliseconds, anything longer is a stall
+const unsigned long STAGE_LIMITS[NUM_WATCHDOG_STAGES] = {
+    0, 60000, 30000, 2000, 10000, 10000, 5000, 60000,
+    1000, 1500, 5000, 15000, 15000, 20000, 600000
+};
+
+// Function for reading previous boot state and starting new ring
+void WatchdogModule::begin() {
+    const rst_info* resetInfo = ESP.getResetInfoPtr();
+    resetReason = resetInfo != nullptr ? resetInfo->reason : REASON_DEFAULT_RST;
+
+    // RTC memory holds garbage after power on, magic tells if state is ours
+    ESP.rtcUserMemoryRead(RTC_BLOCK_OFFSET, (uint32_t*)&previousBoot, sizeof(previousBoot));
+    bool validState = previousBoot.magic == RTC_MAGIC && previousBoot.count <= WATCHDOG_BREADCRUMBS
+        && previousBoot.head < WATCHDOG_BREADCRUMBS && previousBoot.openStage < NUM_WATCHDOG_STAGES;
+    crashReportPending = validState && (resetReason == REASON_WDT_RST || resetReason == REASON_SOFT_WDT_RST
+        || resetReason == REASON_EXCEPTION_RST);
+
+    memset(&state, 0, sizeof(state));
+    state.magic = RTC_MAGIC;
+    writeHeader();
+}
+
+// Function for recording stage entry
+void WatchdogModule::enter(WatchdogStage stage) {
+    unsigned long now = millis();
+    if (depth < WATCHDOG_MAX_DEPTH) {
+        stack[depth] = stage;
+        stackSince[depth] = now;
+        depth++;
+    }
+    state.openStage = stage;
+    state.openSinceMillis = now;
+    addBreadcrumb(stage, CRUMB_ENTER, 0);
+}
+
+// Function for recording stage exit and checking it against stage limit
+void WatchdogModule::exit(WatchdogStage stage) {
+    unsigned long now = millis();
+
+    // Pop stages until the exiting one, inner stages left open by early return are closed with it
+    int index = depth - 1;
+    while (index >= 0 && stack[index] != stage) {
+        index--;
+    }
+    if (index < 0) {
+        return; // Entry was not tracked because of depth limit
+    }
+    unsigned long duration = now - stackSince[index];
+    depth = index;
+
+    bool stalled = duration > STAGE_LIMITS[stage];
+    if (stalled) {
+        stallCount++;
+        lastStallStage = stage;
+        lastStallMillis = duration;
+        LOG_WARNING("Stage %s stalled for %lu ms", STAGE_NAMES[stage], duration);
+    }
+
+    // Outer stage is open again
+    state.openStage = depth > 0 ? stack[depth - 1] : STAGE_NONE;
+    state.openSinceMillis = depth > 0 ? stackSince[depth - 1] : now;
+    addBreadcrumb(stage, stalled ? CRUMB_STALL : CRUMB_EXIT, duration);
+}
+
+// Function for queueing diagnostic events
+void WatchdogModule::reportPending() {
+    char message[INPUT_BUFFER_LIMIT];
+
+    // Crash report is kept until uploads are possible, failure events would be suppressed before that
+    if (crashReportPending && !uploadBreaker.isOpen()) {
+        crashReportPending = false;
+        formatCrashReport(message, sizeof(message));
+        LOG_ERROR("%s", message);
+        handleEvent(ERROR, message, WATCHDOG);
+    }
+
+    if (lastStallStage != STAGE_NONE) {
+        snprintf(message, sizeof(message), "Stage %s stalled for %lu ms (%lu stalls since boot).",
+                 STAGE_NAMES[lastStallStage], lastStallMillis, stallCount);
+        lastStallStage = STAGE_NONE;
+        handleEvent(WARNING, message, WATCHDOG);
+    }
+}
+
+// Function for getting stall count
+unsigned long WatchdogModule::getStallCount() const {
+    return stallCount;
+}
+
+// Function for appending breadcrumb, only the changed blocks of RTC memory are written
+void WatchdogModule::addBreadcrumb(WatchdogStage stage, BreadcrumbKind kind, unsigned long durationMs) {
+    Breadcrumb& crumb = state.crumbs[state.head];
+    crumb.stage = stage;
+    crumb.kind = kind;
+    crumb.durationMs = durationMs > 0xFFFF ? 0xFFFF : (uint16_t)durationMs;
+    crumb.millis = millis();
+
+    uint32_t crumbBlock = RTC_BLOCK_OFFSET + (offsetof(WatchdogRtcState, crumbs) + state.head * sizeof(Breadcrumb)) / 4;
+    ESP.rtcUserMemoryWrite(crumbBlock, (uint32_t*)&crumb, sizeof(crumb));
+
+    state.head = (state.head + 1) % WATCHDOG_BREADCRUMBS;
+    if (state.count < WATCHDOG_BREADCRUMBS) {
+        state.count++;
+    }
+    writeHeader();
+}
+
+// Function for writing state header to RTC memory
+void WatchdogModule::writeHeader() {
+    ESP.rtcUserMemoryWrite(RTC_BLOCK_OFFSET, (uint32_t*)&state, offsetof(WatchdogRtcState, crumbs));
+}
+
+// Function for formatting crash report as "<reset reason> in <stage> after <ms> ms: <trail>"
+// Trail lists latest breadcrumbs oldest first, + is entry, - is exit and ! is stall
+void WatchdogModule::formatCrashReport(char* buffer, size_t size) const {
+    const char* reason = resetReason == REASON_EXCEPTION_RST ? "Exception" : "Watchdog reset";
+    int length = snprintf(buffer, size, "%s in %s", reason, STAGE_NAMES[previousBoot.openStage]);
+
+    // Time in open stage is measured against the last breadcrumb written before reset
+    if (previousBoot.openStage != STAGE_NONE && previousBoot.count > 0) {
+        const Breadcrumb& last = previousBoot.crumbs[(previousBoot.head + WATCHDOG_BREADCRUMBS - 1) % WATCHDOG_BREADCRUMBS];
+        length += snprintf(buffer + length, size - length, " after %lu ms", (unsigned long)(last.millis - previousBoot.openSinceMillis));
+    }
+    length += snprintf(buffer + length, size - length, ":");
+
+    int trail = previousBoot.count < TRAIL_LENGTH ? previousBoot.count : TRAIL_LENGTH;
+    for (int i = trail; i > 0 && length < (int)size - 1; i--) {
+        const Breadcrumb& crumb = previousBoot.crumbs[(previousBoot.head + WATCHDOG_BREADCRUMBS - i) % WATCHDOG_BREADCRUMBS];
+        const char marker = crumb.kind == CRUMB_ENTER ? '+' : (crumb.kind == CRUMB_STALL ? '!' : '-');
+        length += snprintf(buffer + length, size - length, " %c%s", marker,
+                           crumb.stage < NUM_WATCHDOG_STAGES ? STAGE_NAMES[crumb.stage] : "?");
+    }
+}
+
+// Constructor for recording stage entry
+WatchdogScope::WatchdogScope(WatchdogStage stage) : stage(stage) {
+    watchdog.enter(stage);
+}
+
+// Destructor for recording stage exit
+WatchdogScope::~WatchdogScope() {
+    watchdog.exit(stage);
+}
@@ -0,0 +1,120 @@
+/**
+ * File: watchdog_module.h
+ * Author: Joonas Nislin
+ * Date: 19.10.2026
+ * Description: This file contains header file of WatchdogModule.
+ * Holds function declarations and constants for stage tracking, stall detection and crash breadcrumbs.
+ */
+
+#ifndef WATCHDOG_MODULE_H
+#define WATCHDOG_MODULE_H
+
+#include <ESP8266WiFi.h>
+
+#define WATCHDOG_BREADCRUMBS 16 // Entries in RTC breadcrumb ring
+#define WATCHDOG_MAX_DEPTH 4 // Nested stages tracked at once
+
+// Stages of main loop and modules that can block
+enum WatchdogStage : uint8_t {
+    STAGE_NONE,
+    STAGE_SETUP,
+    STAGE_WIFI_CONNECT,
+    STAGE_NTP_UPDATE,
+    STAGE_FIREBASE_READ,
+    STAGE_FIREBASE_WRITE,
+    STAGE_COMMAND_POLL,
+    STAGE_SENSOR_CYCLE,
+    STAGE_DHT_READ,
+    STAGE_ULTRASONIC_READ,
+    STAGE_SOIL_MOISTURE,
+    STAGE_WATERING,
+    STAGE_EVENT_LOOP,
+    STAGE_AUTHORIZATION,
+    STAGE_OTA,
+    NUM_WATCHDOG_STAGES
+};
+
+// Kind of breadcrumb entry
+enum BreadcrumbKind : uint8_t {
+    CRUMB_ENTER,
+    CRUMB_EXIT,
+    CRUMB_STALL // Exit after stage limit was exceeded
+};
+
+// Structure to represent one breadcrumb, 8 bytes so it maps to two RTC memory blocks
+struct Breadcrumb {
+    uint8_t stage;
+    uint8_t kind;
+    uint16_t durationMs; // Time spent in stage, set on exit, saturates at 65535
+    uint32_t millis; // Time since boot
+};
+
+// Structure to represent breadcrumb state kept in RTC memory over resets
+struct WatchdogRtcState {
+    uint32_t magic;
+    uint8_t openStage; // Innermost stage that has not exited
+    uint8_t head; // Next ring index to write
+    uint8_t count; // Entries in ring
+    uint8_t reserved;
+    uint32_t openSinceMillis; // Entry time of open stage
+    Breadcrumb crumbs[WATCHDOG_BREADCRUMBS];
+};
+
+class WatchdogModule {
+public:
+    // Read breadcrumbs of previous boot and start a new ring
+    void begin();
+
+    // Record entry to stage
+    void enter(WatchdogStage stage);
+
+    // Record exit from stage and detect stall
+    void exit(WatchdogStage stage);
+
+    // Queue diagnostic events for previous crash and new stalls, called from main loop
+    void reportPending();
+
+    // Number of stalls since boot
+    unsigned long getStallCount() const;
+
+private:
+    WatchdogRtcState state; // RAM copy of RTC state
+    WatchdogRtcState previousBoot; // State left by previous boot
+    uint32_t resetReason = 0;
+    bool crashReportPending = false;
+    WatchdogStage stack[WATCHDOG_MAX_DEPTH]; // Open stages, innermost last
+    unsigned long stackSince[WATCHDOG_MAX_DEPTH];
+    int depth = 0;
+    unsigned long stallCount = 0;
+    WatchdogStage lastStallStage = STAGE_NONE; // Stall not yet reported
+    unsigned long lastStallMillis = 0;
+
+    // Append breadcrumb to ring and write it to RTC memory
+    void addBreadcrumb(WatchdogStage stage, BreadcrumbKind kind, unsigned long durationMs);
+
+    // Write header part of state to RTC memory
+    void writeHeader();
+
+    // Format crash report of previous boot into buffer
+    void formatCrashReport(char* buffer, size_t size) const;
+
+    // Constants and Configuration Settings
+    static const uint32_t RTC_BLOCK_OFFSET = 32; // First 128 bytes of user RTC memory are used by OTA bootloader
+    static const uint32_t RTC_MAGIC = 0x56535744; // "VSWD"
+    static const int TRAIL_LENGTH = 8; // Breadcrumbs included in crash report
+};
+
+// Scope guard recording stage entry on construction and exit on destruction
+class WatchdogScope {
+public:
+    explicit WatchdogScope(WatchdogStage stage);
+    ~WatchdogScope();
+
+private:
+    WatchdogStage stage;
+};
+
+// Watchdog shared by main loop and modules
+extern WatchdogModule watchdog;
+
+#endif
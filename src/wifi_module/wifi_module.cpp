@@ -9,15 +9,33 @@
 
 #include "wifi_module.h"
 #include "../../config/config.h"
+#include "../watchdog_module/watchdog_module.h"
+#include "../log_module/log_module.h"
+
+#define LOG_TAG "wifi"
 
 void wifiModuleInit() {
-    // WiFi initialization code
+    wifiModuleBegin();
+    wifiModuleWaitConnected();
+}
+
+// Start association in the background, other modules can be initialized meanwhile
+void wifiModuleBegin() {
     WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
+}
+
+// Wait for connection, polled in short steps so connection is noticed right away
+void wifiModuleWaitConnected() {
+    WatchdogScope watchdogScope(STAGE_WIFI_CONNECT);
+    unsigned long lastPrintMillis = millis();
     while (WiFi.status() != WL_CONNECTED) {
-        delay(1000);
-        Serial.println("Connecting to WiFi...");
+        delay(50);
+        if (millis() - lastPrintMillis >= 1000) {
+            LOG_INFO("Connecting to WiFi...");
+            lastPrintMillis = millis();
+        }
     }
-    Serial.println("Connected to WiFi!");
+    LOG_INFO("Connected to WiFi");
 }
 
 // Function to get the unique identifier (MAC address) for the device
@@ -11,7 +11,9 @@
 
 #include <ESP8266WiFi.h>
 
-void wifiModuleInit(); // Initialize the WiFi module
+void wifiModuleInit(); // Initialize the WiFi module and wait for connection
+void wifiModuleBegin(); // Start connecting without waiting
+void wifiModuleWaitConnected(); // Wait until connection started with wifiModuleBegin is up
 String getDeviceId(); // Get the unique device identifier
 String getNetworkName(); // Get the network name (SSID)
 String getLocalIpAsString(); // Get the local IP address as a string
@@ -0,0 +1,114 @@
+#!/usr/bin/env python3
+"""
+File: cost_check.py
+Author: Joonas Nislin
+Date: 19.10.2026
+Description: Compares stage costs printed by the device with a stored baseline.
+The device logs one "COST {json}" line per run of sensor cycle, soil moisture cycle and event drain.
+Lines are read from a captured serial log, the median of each field per stage is used, so one slow
+network round trip does not decide the result.
+- requests, aes_blocks and arena_allocs must not grow
+- bytes and peak_heap may grow by --tolerance percent
+- micros depends on the network and is only reported
+Usage:
+    python3 tools/cost_check.py serial.log --save tools/cost_baseline.json
+    python3 tools/cost_check.py serial.log --baseline tools/cost_baseline.json --output cost_report.json
+"""
+
+import argparse
+import json
+import statistics
+import sys
+
+FIELDS = ("requests", "bytes", "aes_blocks", "arena_allocs", "peak_heap", "micros")
+EXACT_FIELDS = ("requests", "aes_blocks", "arena_allocs")
+TOLERANT_FIELDS = ("bytes", "peak_heap")
+
+
+# Function for reading COST lines of a serial log into samples per stage
+def read_samples(path):
+    samples = {}
+    with open(path, errors="replace") as file:
+        for line in file:
+            index = line.find("COST {")
+            if index < 0:
+                continue
+            try:
+                sample = json.loads(line[index + len("COST "):])
+            except ValueError:
+                continue  # Line was cut or mixed with other output
+            samples.setdefault(sample["stage"], []).append(sample)
+    return samples
+
+
+# Function for computing median of each field per stage
+def summarize(samples):
+    summary = {}
+    for stage, runs in samples.items():
+        summary[stage] = {field: statistics.median(run[field] for run in runs) for field in FIELDS}
+        summary[stage]["runs"] = len(runs)
+    return summary
+
+
+# Function for comparing summary with baseline, returns list of regressions
+def compare(summary, baseline, tolerance):
+    regressions = []
+    for stage, expected in baseline.items():
+        if stage not in summary:
+            regressions.append("%s: no runs in log" % stage)
+            continue
+        actual = summary[stage]
+        for field in EXACT_FIELDS:
+            if actual[field] > expected[field]:
+                regressions.append("%s %s: %g > %g" % (stage, field, actual[field], expected[field]))
+        for field in TOLERANT_FIELDS:
+            limit = expected[field] * (1 + tolerance / 100.0)
+            if actual[field] > limit:
+                regressions.append("%s %s: %g > %g (+%g%%)" % (stage, field, actual[field], expected[field], tolerance))
+    return regressions
+
+
+# Function for printing summary table
+def print_summary(summary):
+    print("%-14s %5s %9s %8s %11s %12s %10s %10s" % ("stage", "runs", "requests", "bytes", "aes_blocks",
+                                                    "arena_allocs", "peak_heap", "micros"))
+    for stage in sorted(summary):
+        row = summary[stage]
+        print("%-14s %5d %9g %8g %11g %12g %10g %10g" % (stage, row["runs"], row["requests"], row["bytes"],
+                                                        row["aes_blocks"], row["arena_allocs"], row["peak_heap"],
+                                                        row["micros"]))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compare stage costs of a serial log with a baseline")
+    parser.add_argument("log", help="Captured serial output with COST lines")
+    parser.add_argument("--baseline", help="Baseline JSON, a regression fails with exit code 1")
+    parser.add_argument("--save", help="Write summary as new baseline")
+    parser.add_argument("--output", help="Write summary and regressions as JSON")
+    parser.add_argument("--tolerance", type=float, default=10.0, help="Allowed growth of bytes and peak_heap in percent")
+    args = parser.parse_args()
+
+    summary = summarize(read_samples(args.log))
+    if not summary:
+        sys.exit("No COST lines in " + args.log)
+    print_summary(summary)
+
+    regressions = []
+    if args.baseline:
+        with open(args.baseline) as file:
+            regressions = compare(summary, json.load(file), args.tolerance)
+        for regression in regressions:
+            print("Regression: " + regression)
+
+    if args.save:
+        with open(args.save, "w") as file:
+            json.dump(summary, file, indent=2, sort_keys=True)
+    if args.output:
+        with open(args.output, "w") as file:
+            json.dump({"stages": summary, "regressions": regressions}, file, indent=2, sort_keys=True)
+    if regressions:
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
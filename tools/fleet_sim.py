@@ -0,0 +1,332 @@
+#!/usr/bin/env python3
+"""
+File: fleet_sim.py
+Author: Joonas Nislin
+Date: 19.10.2026
+Description: Estimates backend write load of a device fleet against a local Firebase REST stand-in.
+N virtual devices replay the write pattern of the firmware in simulated time, every write is a real
+HTTP request to a stub server on localhost that keeps the database tree in memory:
+- Registration: authorized_devices/<id> and devices/<id> once per boot
+- Sensor cycle every --sensor-interval minutes: temperature, humidity, air pressure, luminosity, water
+  tank level and latest sensor reading time, each a PATCH of devices/<id> and one daily history bucket entry
+- Soil moisture cycle once a day per plant, watering writes latest watering time and soil moisture again,
+  low water tank writes a refill notification instead
+- Events as one multi-location PATCH of events/<severity>/<date><encSSID>/<id>
+Ciphertext is random hex of the length the firmware produces, so bytes match a real upload.
+The stub understands PATCH, PUT, GET (also shallow=true) and DELETE of /<path>.json and answers like the REST API.
+Report shows writes per second, bytes and node count growth per tree over the simulated period.
+Usage:
+    python3 tools/fleet_sim.py --devices 200 --days 7
+    python3 tools/fleet_sim.py --devices 50 --sensor-interval 10 --plants 3 --output fleet_report.json
+"""
+
+import argparse
+import http.client
+import json
+import random
+import sys
+import threading
+import time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+TREES = ("authorized_devices", "devices", "history", "events", "notifications")
+N_BLOCK = 16
+SECONDS_PER_DAY = 24 * 60 * 60
+START_EPOCH = 1792368000  # Midnight the simulation starts from, buckets use UTC days
+SSID = "greenhouse"
+
+
+# Function for computing hex length of encrypted value, same as ENCRYPTED_HEX_LENGTH without terminator
+def encrypted_hex_length(length):
+    return 2 * (length // N_BLOCK + 1) * N_BLOCK
+
+
+# Function for producing ciphertext stand-in of given plaintext
+def encrypt(plaintext, rng):
+    return "%0*x" % (encrypted_hex_length(len(plaintext)), rng.getrandbits(4 * encrypted_hex_length(len(plaintext))))
+
+
+# Function for formatting "YYYY/MM/DD/" of epoch like getFormattedDate
+def formatted_date(epoch):
+    return time.strftime("%Y/%m/%d/", time.gmtime(epoch))
+
+
+# Function for counting leaf nodes below a node
+def count_leaves(node):
+    if isinstance(node, dict):
+        return sum(count_leaves(child) for child in node.values())
+    return 1
+
+
+class Database:
+    """In-memory database tree with the write semantics of the REST API."""
+
+    def __init__(self):
+        self.root = {}
+        self.lock = threading.Lock()
+        self.writes = {tree: 0 for tree in TREES + ("other",)}
+        self.bytes = {tree: 0 for tree in TREES + ("other",)}
+
+    # Function for splitting path into keys
+    @staticmethod
+    def keys(path):
+        return [key for key in path.split("/") if key]
+
+    # Function for writing value to path, missing parents are created and null deletes the node
+    def put(self, keys, value):
+        if not keys:
+            self.root = value if isinstance(value, dict) else {}
+            return
+        if value is None:
+            parent = self.get(keys[:-1])
+            if isinstance(parent, dict):
+                parent.pop(keys[-1], None)
+            return
+        node = self.root
+        for key in keys[:-1]:
+            if not isinstance(node.get(key), dict):
+                node[key] = {}
+            node = node[key]
+        node[keys[-1]] = value
+
+    # Function for reading value of path
+    def get(self, keys):
+        node = self.root
+        for key in keys:
+            if not isinstance(node, dict) or key not in node:
+                return None
+            node = node[key]
+        return node
+
+    # Function for accounting write to tree of path
+    def record(self, keys, length):
+        tree = keys[0] if keys and keys[0] in TREES else "other"
+        self.writes[tree] += 1
+        self.bytes[tree] += length
+
+    # Function for counting leaf nodes per tree
+    def node_counts(self):
+        with self.lock:
+            counts = {tree: count_leaves(self.root.get(tree, {})) if tree in self.root else 0 for tree in TREES}
+            counts["other"] = sum(count_leaves(value) for key, value in self.root.items() if key not in TREES)
+        return counts
+
+
+class RestHandler(BaseHTTPRequestHandler):
+    """Answers /<path>.json requests like the Firebase Realtime Database REST API."""
+
+    protocol_version = "HTTP/1.1"  # Keep-alive, the firmware reuses its TLS connection too
+
+    # Function for splitting request target into database keys and query
+    def target(self):
+        path, _, query = self.path.partition("?")
+        if not path.endswith(".json"):
+            return None, query
+        return Database.keys(path[:-len(".json")]), query
+
+    # Function for answering with JSON body or empty 204
+    def answer(self, code, value, silent=False):
+        body = b"" if silent else json.dumps(value, separators=(",", ":")).encode()
+        self.send_response(204 if silent else code)
+        self.send_header("Content-Type", "application/json")
+        self.send_header("Content-Length", str(len(body)))
+        self.end_headers()
+        self.wfile.write(body)
+
+    # Function for reading JSON request body
+    def body(self):
+        raw = self.rfile.read(int(self.headers.get("Content-Length", 0)))
+        return raw, json.loads(raw) if raw else None
+
+    def do_GET(self):
+        keys, query = self.target()
+        if keys is None:
+            return self.answer(404, {"error": "404 Not Found"})
+        with self.server.database.lock:
+            value = self.server.database.get(keys)
+            if "shallow=true" in query and isinstance(value, dict):
+                value = {key: True for key in value}
+        self.answer(200, value)
+
+    def do_PUT(self):
+        keys, query = self.target()
+        raw, value = self.body()
+        with self.server.database.lock:
+            self.server.database.put(keys, value)
+            self.server.database.record(keys, len(self.path) + len(raw))
+        self.answer(200, value, "print=silent" in query)
+
+    def do_PATCH(self):
+        keys, query = self.target()
+        raw, value = self.body()
+        if keys is None or not isinstance(value, dict):
+            return self.answer(400, {"error": "Invalid data; couldn't parse JSON object."})
+        with self.server.database.lock:
+            # Child keys may be paths, this is how events write several fields of one message at once
+            for key, child in value.items():
+                self.server.database.put(keys + Database.keys(key), child)
+            self.server.database.record(keys, len(self.path) + len(raw))
+        self.answer(200, value, "print=silent" in query)
+
+    def do_DELETE(self):
+        keys, _ = self.target()
+        with self.server.database.lock:
+            self.server.database.put(keys, None)
+            self.server.database.record(keys, len(self.path))
+        self.answer(200, None)
+
+    def log_message(self, format, *args):
+        pass  # One line per request would hide the report
+
+
+class VirtualDevice:
+    """Issues the uploads of one device in the order and shape the firmware does."""
+
+    def __init__(self, index, args, rng, connection):
+        self.id = "5CCF7F%06X" % index
+        self.args = args
+        self.rng = rng
+        self.connection = connection
+        self.ssid = encrypt(SSID, rng)
+
+    # Function for PATCHing JSON object to node path
+    def patch(self, path, value):
+        body = json.dumps(value, separators=(",", ":"))
+        self.connection.request("PATCH", "/%s.json?print=silent&auth=secret" % path, body,
+                                {"Content-Type": "application/json"})
+        response = self.connection.getresponse()
+        response.read()
+        if response.status not in (200, 204):
+            sys.exit("Stub refused %s with %d" % (path, response.status))
+
+    # Function for uploading reading like setupApiCallWithHistoryData
+    def upload_reading(self, epoch, key, plaintext):
+        value = encrypt(plaintext, self.rng)
+        self.patch("devices/" + self.id, {key: value})
+        day_start = epoch - epoch % SECONDS_PER_DAY
+        self.patch("history/%s/%s%s/%s/%d" % (key, formatted_date(epoch), self.ssid, self.id, day_start),
+                   {str(epoch - day_start): value})
+
+    # Function for registering device like registerDeviceForAuthorization after boot
+    def register(self, epoch):
+        self.patch("authorized_devices/" + self.id, {"authorized": False, "ssid": self.ssid,
+                                                     "macAddress": encrypt(self.id, self.rng),
+                                                     "name": encrypt("IoT Device", self.rng)})
+        self.patch("devices/" + self.id, {"name": encrypt("IoT Device", self.rng), "firmware": encrypt("1.4.0", self.rng),
+                                          "ip": encrypt("192.168.1.100", self.rng), "ssid": self.ssid,
+                                          "macAddress": encrypt(self.id, self.rng)})
+
+    # Function for running sensor cycle like handleSensorReadings
+    def sensor_cycle(self, epoch):
+        for key in ("temperature", "humidity", "air_pressure", "luminosity", "water_tank_level"):
+            self.upload_reading(epoch, key, "%.2f" % self.rng.uniform(10, 100))
+        self.upload_reading(epoch, "latest_sensor_reading_time", str(epoch))
+
+    # Function for running soil moisture cycle like handleSoilMoistureReading
+    def soil_cycle(self, epoch):
+        for plant in range(self.args.plants):
+            key = "soil_moisture" if plant == 0 else "soil_moisture_%d" % plant
+            self.upload_reading(epoch, key, "%.2f" % self.rng.uniform(0, 100))
+
+    # Function for running watering sequence once soil is dry
+    def watering(self, epoch):
+        if self.rng.random() < self.args.refill_share:
+            self.patch("notifications/%s%s/%s/%d" % (formatted_date(epoch), self.ssid, self.id, epoch),
+                       {"refill_water_tank": encrypt(str(epoch), self.rng), "notification_read": False})
+            return
+        self.upload_reading(epoch, "latest_watering_time", str(epoch))
+        self.soil_cycle(epoch)  # Soil is read again after pump stops
+
+    # Function for sending event like sendEventToFirebase
+    def event(self, epoch):
+        severity = self.rng.choice(("INFO", "INFO", "WARNING", "ERROR"))
+        message_id = "%d:%s" % (epoch, severity)
+        fields = {"timestamp": str(epoch), "hostname": encrypt("IoT Device", self.rng),
+                  "severity": encrypt(severity, self.rng), "facility": encrypt("DEVICE", self.rng),
+                  "message": encrypt("x" * self.args.event_length, self.rng), "messageId": message_id,
+                  "ssid": self.ssid, "count": 1}
+        self.patch("events/%s/%s%s/%s/" % (severity, formatted_date(epoch), self.ssid, self.id),
+                   {message_id + "/" + key: value for key, value in fields.items()})
+
+
+# Function for building time ordered schedule of all uploads of the fleet
+def build_schedule(devices, args, rng):
+    end = START_EPOCH + int(args.days * SECONDS_PER_DAY)
+    interval = int(args.sensor_interval * 60)
+    schedule = []
+    for device in devices:
+        boot = START_EPOCH + rng.randrange(interval)  # Devices are not started at the same moment
+        schedule.append((boot, device.register))
+        for epoch in range(boot, end, interval):
+            schedule.append((epoch, device.sensor_cycle))
+        for epoch in range(boot, end, SECONDS_PER_DAY):
+            schedule.append((epoch, device.soil_cycle))
+            if rng.random() < args.watering_share:
+                schedule.append((epoch + 60, device.watering))
+        for _ in range(int(args.events_per_day * args.days)):
+            schedule.append((rng.randrange(boot, end), device.event))
+    schedule.sort(key=lambda entry: entry[0])
+    return schedule
+
+
+# Function for printing report table
+def print_report(report):
+    print("%d devices, %.1f days, %d requests in %.1f s" % (report["devices"], report["days"],
+                                                             report["requests"], report["wall_seconds"]))
+    print("%-19s %12s %12s %14s %12s %14s" % ("tree", "writes", "writes/s", "bytes", "nodes", "nodes/day"))
+    for tree, row in report["trees"].items():
+        print("%-19s %12d %12.3f %14d %12d %14.1f" % (tree, row["writes"], row["writes_per_second"], row["bytes"],
+                                                      row["nodes"], row["nodes_per_day"]))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Replay fleet write pattern against a local Firebase REST stand-in")
+    parser.add_argument("--devices", type=int, default=100, help="Number of virtual devices")
+    parser.add_argument("--days", type=float, default=1.0, help="Simulated period in days")
+    parser.add_argument("--sensor-interval", type=float, default=29.0, help="Minutes between sensor cycles")
+    parser.add_argument("--plants", type=int, default=1, help="Plants per device, like NUM_PLANTS")
+    parser.add_argument("--watering-share", type=float, default=0.3, help="Share of days a plant needs water")
+    parser.add_argument("--refill-share", type=float, default=0.1, help="Share of waterings refused for low tank")
+    parser.add_argument("--events-per-day", type=float, default=2.0, help="Events sent by one device per day")
+    parser.add_argument("--event-length", type=int, default=48, help="Plaintext length of event message")
+    parser.add_argument("--seed", type=int, default=1, help="Random seed, same seed gives same report")
+    parser.add_argument("--output", help="Write report as JSON")
+    args = parser.parse_args()
+
+    server = ThreadingHTTPServer(("127.0.0.1", 0), RestHandler)
+    server.database = Database()
+    threading.Thread(target=server.serve_forever, daemon=True).start()
+
+    rng = random.Random(args.seed)
+    connection = http.client.HTTPConnection("127.0.0.1", server.server_address[1])
+    devices = [VirtualDevice(index, args, rng, connection) for index in range(args.devices)]
+    schedule = build_schedule(devices, args, rng)
+
+    started = time.monotonic()
+    for epoch, upload in schedule:
+        upload(epoch)
+    wall_seconds = time.monotonic() - started
+    server.shutdown()
+
+    database = server.database
+    counts = database.node_counts()
+    simulated_seconds = args.days * SECONDS_PER_DAY
+    report = {"devices": args.devices, "days": args.days, "wall_seconds": round(wall_seconds, 3),
+              "requests": sum(database.writes.values()), "trees": {}}
+    for tree in TREES + ("other",):
+        report["trees"][tree] = {
+            "writes": database.writes[tree],
+            "writes_per_second": database.writes[tree] / simulated_seconds,
+            "bytes": database.bytes[tree],
+            "nodes": counts[tree],
+            "nodes_per_day": counts[tree] / args.days,
+        }
+    print_report(report)
+
+    if args.output:
+        with open(args.output, "w") as file:
+            json.dump(report, file, indent=2, sort_keys=True)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,139 @@
+#!/usr/bin/env python3
+"""
+File: memory_report.py
+Author: Joonas Nislin
+Date: 19.10.2026
+Description: Prints DRAM, IRAM and flash usage of each module from object files of an ESP8266 build.
+Sections are classified the same way as the ESP8266 core linker script places them:
+- DRAM: .data, .rodata, .bss and COMMON, string literals without PROGMEM end up here
+- IRAM: .iram sections, functions with IRAM_ATTR
+- Flash: .text, .literal and .irom sections, code and PROGMEM data
+Usage:
+    arduino-cli compile --fqbn esp8266:esp8266:nodemcuv2 --build-path build
+    python3 tools/memory_report.py build [--baseline tools/memory_baseline.json] [--save tools/memory_baseline.json]
+"""
+
+import argparse
+import glob
+import json
+import os
+import shutil
+import subprocess
+import sys
+
+CATEGORIES = ("dram", "iram", "flash")
+
+
+# Function for finding size tool of the xtensa toolchain
+def find_size_tool():
+    tool = shutil.which("xtensa-lx106-elf-size")
+    if tool:
+        return tool
+    pattern = os.path.expanduser("~/.arduino15/packages/esp8266/tools/xtensa-lx106-elf-gcc/*/bin/xtensa-lx106-elf-size")
+    matches = sorted(glob.glob(pattern))
+    if not matches:
+        sys.exit("xtensa-lx106-elf-size not found, add the ESP8266 toolchain to PATH")
+    return matches[-1]
+
+
+# Function for mapping section name to memory category
+def classify(section):
+    if section.startswith(".iram"):
+        return "iram"
+    if section.startswith((".data", ".rodata", ".bss", "COMMON")):
+        return "dram"
+    if section.startswith((".text", ".literal", ".irom")):
+        return "flash"
+    return None  # Debug and bookkeeping sections are not loaded
+
+
+# Function for summing section sizes of one object file
+def object_usage(size_tool, path):
+    usage = dict.fromkeys(CATEGORIES, 0)
+    output = subprocess.run([size_tool, "-A", path], capture_output=True, text=True, check=True).stdout
+    for line in output.splitlines():
+        fields = line.split()
+        if len(fields) < 2 or not fields[1].isdigit():
+            continue
+        category = classify(fields[0])
+        if category:
+            usage[category] += int(fields[1])
+    return usage
+
+
+# Function for resolving module of object file, src/<module>/<file>.cpp.o belongs to <module>
+def module_name(path):
+    parts = path.replace(os.sep, "/").split("/")
+    if "src" in parts and parts.index("src") + 2 < len(parts):
+        return parts[parts.index("src") + 1]
+    return "sketch"
+
+
+# Function for collecting usage of every module under build path
+def collect(build_path):
+    size_tool = find_size_tool()
+    objects = glob.glob(os.path.join(build_path, "sketch", "**", "*.o"), recursive=True)
+    if not objects:
+        sys.exit("No object files under " + os.path.join(build_path, "sketch"))
+    modules = {}
+    for path in objects:
+        usage = object_usage(size_tool, path)
+        total = modules.setdefault(module_name(path), dict.fromkeys(CATEGORIES, 0))
+        for category in CATEGORIES:
+            total[category] += usage[category]
+    return modules
+
+
+# Function for printing usage table with changes against baseline
+def print_report(modules, baseline):
+    print("%-20s %8s %8s %8s" % ("module", "DRAM", "IRAM", "flash"))
+    totals = dict.fromkeys(CATEGORIES, 0)
+    for name in sorted(modules):
+        usage = modules[name]
+        columns = []
+        for category in CATEGORIES:
+            totals[category] += usage[category]
+            column = "%8d" % usage[category]
+            if baseline is not None:
+                delta = usage[category] - baseline.get(name, {}).get(category, 0)
+                column += " (%+d)" % delta if delta else ""
+            columns.append(column)
+        print("%-20s %s" % (name, " ".join(columns)))
+    print("%-20s %8d %8d %8d" % ("total", totals["dram"], totals["iram"], totals["flash"]))
+
+
+# Function for checking if DRAM or IRAM grew from baseline
+def has_regression(modules, baseline):
+    regression = False
+    for name, usage in modules.items():
+        for category in ("dram", "iram"):
+            if usage[category] > baseline.get(name, {}).get(category, 0):
+                print("%s %s grew by %d bytes" % (name, category.upper(),
+                      usage[category] - baseline.get(name, {}).get(category, 0)))
+                regression = True
+    return regression
+
+
+def main():
+    parser = argparse.ArgumentParser(description="DRAM, IRAM and flash usage per module")
+    parser.add_argument("build_path", help="Build path given to arduino-cli compile")
+    parser.add_argument("--baseline", help="JSON file of previous report, changes are printed and DRAM or IRAM growth fails")
+    parser.add_argument("--save", help="Write report as JSON, for example to update the baseline")
+    args = parser.parse_args()
+
+    modules = collect(args.build_path)
+    baseline = None
+    if args.baseline and os.path.exists(args.baseline):
+        with open(args.baseline) as file:
+            baseline = json.load(file)
+
+    print_report(modules, baseline)
+    if args.save:
+        with open(args.save, "w") as file:
+            json.dump(modules, file, indent=2, sort_keys=True)
+    if baseline is not None and has_regression(modules, baseline):
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()